@@ -0,0 +1,42 @@
+#!/bin/sh
+
+# Release build
+DEFINES=""
+COMPILE_FLAGS="-O2 -g"
+# Debug build
+# DEFINES="-DGJ_DEBUG"
+# COMPILE_FLAGS="-O0 -g"
+
+INCLUDES="-I../gj"
+LIBRARIES=""
+
+SOURCES=../linux_bench.c
+EXECUTABLE="-o linux_bench"
+
+# Reference parser, compiled in when yyjson's sources (e.g. release 0.10.0)
+# are checked out in yyjson/ next to gj. Nothing is fetched, without them the
+# yyjson benchmark is skipped. Set to 0 to always skip it.
+BENCH_YYJSON=1
+BENCH_DEFINES=""
+BENCH_INCLUDES=""
+if [ "$BENCH_YYJSON" = "1" ]; then
+    if [ -f yyjson/src/yyjson.c ]; then
+        BENCH_DEFINES="-DGJSON_BENCH_YYJSON=1"
+        BENCH_INCLUDES="-I../yyjson/src"
+        SOURCES="$SOURCES ../yyjson/src/yyjson.c"
+    else
+        echo "yyjson/src/yyjson.c not found, skipping the yyjson benchmark"
+    fi
+fi
+
+# Benchmark and regression gate, e.g.
+#   build/linux_bench corpus.ndjson login --ndjson --output bench.json
+#   build/linux_bench corpus.ndjson login --ndjson --baseline bench.json --threshold 0.10 \
+#       --p50-threshold 0.10 --p99-threshold 0.25 --rss-threshold 0.10
+mkdir -p build
+cd build
+cc $DEFINES $BENCH_DEFINES $COMPILE_FLAGS $INCLUDES $BENCH_INCLUDES $SOURCES $EXECUTABLE $LIBRARIES
+
+# 64-bit offsets over a >4 GB mmap of a 1 MB file, needs ~4 GB of address space, e.g.
+#   build/linux_large_test /tmp/large_test.json
+cc $COMPILE_FLAGS $INCLUDES ../linux_large_test.c -o linux_large_test
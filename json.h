@@ -3,6 +3,13 @@
 
 #include <gj/gj_base.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GJSON_SSE2 1
+#include <emmintrin.h>
+#else
+#define GJSON_SSE2 0
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // API
 //////////////////////////////////////////////////////////////////////
@@ -12,13 +19,40 @@ typedef struct GJSON_State
     void*  data;
     size_t size;
     MemoryArena memory_arena;
+    // NOTE: Resumable parse stack, pushed from memory_arena by gjson_init
+    struct JSONParseQueue* parse_queue;
+    // NOTE: Arena usage right after gjson_init, gjson_reset returns here
+    size_t memory_base_used;
+    size_t memory_high_water_mark;
 } GJSON_State;
 
+#define JSON_PARSE_QUEUE_SIZE 100
+// NOTE: Whole parse stack, rollback works whether containers were opened or
+//       closed since, and mid-key
+typedef struct GJSON_Checkpoint
+{
+    size_t        memory_used;
+    int           parse_queue_count;
+    unsigned char parse_queue[JSON_PARSE_QUEUE_SIZE];
+    unsigned char parse_state;
+    u32           string_match;
+    int           string_cursor;
+} GJSON_Checkpoint;
+
 typedef enum GJSON_QueryType
 {
-    GJSON_QueryType_ObjectKey
+    GJSON_QueryType_ObjectKey,
+    // NOTE: Any of up to GJSON_QUERY_MAX_KEYS keys, GJSON_QueryResult.key_index tells which
+    GJSON_QueryType_ObjectKeys
 } GJSON_QueryType;
 
+typedef struct GJSON_QueryKey
+{
+    int   string_length;
+    char* string;
+} GJSON_QueryKey;
+
+#define GJSON_QUERY_MAX_KEYS 32
 typedef struct GJSON_Query
 {
     GJSON_QueryType type;
@@ -30,27 +64,71 @@ typedef struct GJSON_Query
             int   string_length;
             char* string;
         };
+        struct
+        {
+            int             key_count;
+            GJSON_QueryKey* keys;
+        };
     };
 } GJSON_Query;
 
 typedef enum GJSON_QueryResultType
 {
     GJSON_QueryResultType_NeedMoreBytes,
-    GJSON_QueryResultType_Hit
+    GJSON_QueryResultType_Hit,
+    // NOTE: Malformed input, read_bytes is the offending byte. Sticky until
+    //       gjson_reset/gjson_rollback.
+    GJSON_QueryResultType_Error
 } GJSON_QueryResultType;
 
 typedef struct GJSON_QueryResult
 {
     GJSON_QueryResultType type;
     size_t read_bytes;
+    // NOTE: Hit only. Offset of the matched key's opening quote, 0 if the
+    //       key started in an earlier buffer.
+    size_t match_start;
+    int    key_index;
 } GJSON_QueryResult;
 
+typedef struct GJSON_Span
+{
+    size_t start;
+    size_t end;
+} GJSON_Span;
+
 ///////////////////////////////////
 // Methods
 ///////////////////////////////////
 static GJSON_State gjson_init(void* memory, size_t memory_size);
+// NOTE: Smallest memory_size gjson_init accepts
+static size_t gjson_minimum_memory_size();
+// NOTE: Carves memory_size bytes out of parent's arena for e.g. a worker thread
+static GJSON_State gjson_init_sub_state(GJSON_State* parent, size_t memory_size);
+// NOTE: Frees everything pushed since gjson_init and clears the parse stack
+static void gjson_reset(GJSON_State* gjson);
+// NOTE: Rollback frees arena memory pushed after the checkpoint and restores
+//       the parse stack, e.g. around each document
+static GJSON_Checkpoint gjson_checkpoint(GJSON_State* gjson);
+static void             gjson_rollback  (GJSON_State* gjson, GJSON_Checkpoint checkpoint);
+// NOTE: Most arena memory ever in use, for sizing memory_size to actual need
+static size_t gjson_memory_high_water_mark(GJSON_State* gjson);
 // return (size_t)bytes read by gj_parse_json
 static GJSON_QueryResult gjson_search(GJSON_State* gjson, GJSON_Query query);
+// NOTE: Fast path for small, complete, in-memory documents: up to
+//       hit_capacity hits are written to hits in one call with the parse
+//       stack on the stack, nothing is resumable. data must be followed by
+//       GJSON_PADDING readable bytes. Returns the hit count, -1 if malformed
+//       or cut off before its last value ends.
+#define GJSON_PADDING 16
+static int gjson_search_small(const void* data, size_t size, GJSON_Query query,
+                              GJSON_QueryResult* hits, int hit_capacity);
+// NOTE: Call after a Hit with gjson->data pointing just past the matched key.
+//       Skips the member's value without decoding it and leaves the parser
+//       after it, value is relative to gjson->data. Returns Hit once skipped,
+//       NeedMoreBytes with the parser untouched if data ends before the value
+//       does, or Error (sticky as for gjson_search) if the member is malformed.
+static GJSON_QueryResultType gjson_skip_member_value(GJSON_State* gjson, GJSON_Span* value);
 
 //////////////////////////////////////////////////////////////////////
 // Defines
@@ -73,103 +151,47 @@ static GJSON_QueryResult gjson_search(GJSON_State* gjson, GJSON_Query query);
 #define GJSON_NULL  "null"
 
 //////////////////////////////////////////////////////////////////////
-// JSONParseState/Queue
+// JSONParseQueue
 //////////////////////////////////////////////////////////////////////
 typedef enum JSONStateType
 {
-    JSONStateType_Undefined      = 0,
-    JSONStateType_SkipWhitespace = 1,
-    JSONStateType_Value          = 2,
-    JSONStateType_MoveCursor     = 3,
-    JSONStateType_Object         = 4,
-    JSONStateType_Array          = 5,
-    JSONStateType_String         = 6,
-    JSONStateType_Number         = 7,
-    JSONStateType_True           = 8,
-    JSONStateType_False          = 9,
-    JSONStateType_Null           = 10
+    JSONStateType_Undefined = 0,
+    JSONStateType_Object    = 1,
+    JSONStateType_Array     = 2
 } JSONStateType;
 
-typedef enum JSONObjectState
-{
-    JSONObjectState_Start       = 0,
-    JSONObjectState_End         = 1,
-    JSONObjectState_KeyBefore   = 2,
-    JSONObjectState_Key         = 3,
-    JSONObjectState_KeyAfter    = 4,
-    JSONObjectState_Colon       = 5,
-    JSONObjectState_ValueBefore = 6,
-    JSONObjectState_Value       = 7,
-    JSONObjectState_ValueAfter  = 8,
-    JSONObjectState_CheckNext   = 9
-} JSONObjectState;
-
-typedef enum JSONArrayState
-{
-    JSONArrayState_Start       = 0,
-    JSONArrayState_End         = 1,
-    JSONArrayState_ValueBefore = 2,
-    JSONArrayState_Value       = 3,
-    JSONArrayState_ValueAfter  = 4,
-    JSONArrayState_CheckNext   = 5
-} JSONArrayState;
-
-typedef enum JSONStringState
-{
-    JSONStringState_Start     = 0,
-    JSONStringState_Char      = 1,
-    JSONStringState_Backslash = 2
-} JSONStringState;
-
-typedef enum JSONNumberState
-{
-    JSONNumberState_IntegerSign = 0,
-    JSONNumberState_Integer   = 1,
-    JSONNumberState_Fraction  = 2,
-    JSONNumberState_FractionInteger = 3,
-    JSONNumberState_Exponent,
-    JSONNumberState_ExponentSign,
-    JSONNumberState_ExponentInteger,
-} JSONNumberState;
-
-typedef struct JSONParseState
-{
-#if GJ_DEBUG
-    JSONStateType type;
-#else
-    char type;
-#endif
-    unsigned char state; // TODO: Either document or do something about largest string = 255
-} JSONParseState;
+// NOTE: States below JSONLexState_TableCount are driven by
+//       gjson_lex_transitions, string states scan ahead instead.
+typedef enum JSONLexState
+{
+    JSONLexState_Value        = 0,
+    JSONLexState_ArrayFirst   = 1,
+    JSONLexState_ObjectFirst  = 2,
+    JSONLexState_ObjectKey    = 3,
+    JSONLexState_Colon        = 4,
+    JSONLexState_AfterValue   = 5,
+    JSONLexState_Scalar       = 6,
+    JSONLexState_Error        = 7,
+    JSONLexState_TableCount   = 8,
+
+    JSONLexState_Key          = 8,
+    JSONLexState_KeyEscape    = 9,
+    JSONLexState_String       = 10,
+    JSONLexState_StringEscape = 11
+} JSONLexState;
 
-#define JSON_PARSE_QUEUE_SIZE 100
 typedef struct JSONParseQueue
 {
-    JSONParseState queue[JSON_PARSE_QUEUE_SIZE];
+    // NOTE: Open containers, JSONStateType_Object/Array
+    unsigned char queue[JSON_PARSE_QUEUE_SIZE];
     int count;
-} JSONParseQueue;
 
-static JSONParseQueue json_parse_queue;
-
-static void json_parse_queue_push(JSONStateType type)
-{
-    gj_Assert(json_parse_queue.count <= JSON_PARSE_QUEUE_SIZE);
-    gj_ZeroMemory(&json_parse_queue.queue[json_parse_queue.count]);
-    json_parse_queue.queue[json_parse_queue.count].type = type;
-    json_parse_queue.count++;
-}
-
-static void json_parse_queue_pop()
-{
-    gj_Assert(json_parse_queue.count > 0);
-    json_parse_queue.count--;
-}
-
-static JSONParseState* json_parse_queue_current()
-{
-    gj_Assert(json_parse_queue.count > 0);
-    return &json_parse_queue.queue[json_parse_queue.count - 1];
-}
+    // NOTE: JSONLexState and, in a key, candidate key bits still matching
+    //       and chars matched so far
+    unsigned char state;
+    u32 string_match;
+    int string_cursor;
+} JSONParseQueue;
 
 //////////////////////////////////////////////////////////////////////
 // JSONParseData
@@ -179,606 +201,723 @@ typedef struct JSONParseData
     // TODO: Unicode
     char*        data;
     size_t       size;
-    unsigned int cursor;
+    size_t       cursor;
     MemoryArena* memory_arena;
     GJSON_Query  query;
+    JSONParseQueue* parse_queue;
+
+    // NOTE: Keys of query, ObjectKey is a single key set
+    GJSON_QueryKey* keys;
+    int             key_count;
+    size_t          match_start;
+    int             match_key_index;
+
+    // NOTE: Set to count hits in hit_count without returning on each one
+    int             count_hits;
+    u64             hit_count;
 } JSONParseData;
 
 typedef enum JSONParseResult
 {
     JSONParseResult_OutOfBytes   = 0,
     JSONParseResult_QueryDone    = 1,
-    JSONParseResult_QueryNotDone = 2
+    JSONParseResult_Error        = 2
 } JSONParseResult;
 
-static JSONParseResult gjson_parse_value      (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_object     (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_object_push(JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_object_pop (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_array      (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_array_push (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_array_pop  (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_string     (JSONParseData* json_parse_data, const char* match, int match_length);
-static JSONParseResult gjson_parse_string_push(JSONParseData* json_parse_data, const char* match, int match_length);
-static JSONParseResult gjson_parse_string_pop (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_number     (JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_number_push(JSONParseData* json_parse_data);
-static JSONParseResult gjson_parse_number_pop (JSONParseData* json_parse_data);
-
-static JSONParseResult gjson_parse_literal_push(JSONParseData* json_parse_data, JSONStateType type, JSONParseResult literal_size);
-static JSONParseResult gjson_parse_literal_pop(JSONParseData* json_parse_data);
-
-static inline unsigned int gjson_get_remaining_bytes(JSONParseData* json_parse_data) { return json_parse_data->size - json_parse_data->cursor; }
-static inline int gjson_out_of_bytes(JSONParseData* json_parse_data) { return json_parse_data->cursor >= json_parse_data->size; }
-#define ReturnIfOutOfBytes() if (gjson_out_of_bytes(json_parse_data)) return JSONParseResult_OutOfBytes;
-
-static inline char gjson_feed_current_char(JSONParseData* json_parse_data)
-{
-    gj_Assert(json_parse_data->cursor < json_parse_data->size);
-    return json_parse_data->data[json_parse_data->cursor++];
-}
+static JSONParseResult gjson_parse(JSONParseData* json_parse_data);
 
-static inline char gjson_peek_current_char(JSONParseData* json_parse_data)
+static inline int gjson_lowest_bit_index(u32 value)
 {
-    gj_Assert(json_parse_data->cursor < json_parse_data->size);
-    return json_parse_data->data[json_parse_data->cursor];
+    gj_Assert(value);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (int)index;
+#else
+    return __builtin_ctz(value);
+#endif
 }
 
-static inline char* gjson_get_current_cursor(JSONParseData* json_parse_data)
+static inline int gjson_is_string_special(unsigned char c)
 {
-    gj_Assert(json_parse_data->cursor < json_parse_data->size);
-    return &json_parse_data->data[json_parse_data->cursor];
+    return c < 0x20 || c == GJSON_STRING || c == '\\';
 }
 
-static inline void gjson_increment_cursor(JSONParseData* json_parse_data, int increment)
+// NOTE: Offset of the first quote, backslash or control char, or size
+static size_t gjson_find_string_special(const char* data, size_t size)
 {
-    gj_Assert(json_parse_data->cursor + 1 < json_parse_data->size);
-    json_parse_data->cursor += increment;
+    size_t i = 0;
+#if GJSON_SSE2
+    const __m128i quote     = _mm_set1_epi8(GJSON_STRING);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control   = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i mask  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                  _mm_cmpeq_epi8(chunk, backslash)),
+                                     _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int bits = _mm_movemask_epi8(mask);
+        if (bits) return i + gjson_lowest_bit_index((u32)bits);
+    }
+#endif
+    for (; i < size; i++)
+    {
+        if (gjson_is_string_special((unsigned char)data[i])) return i;
+    }
+    return size;
 }
 
-//////////////////////////////////////////////////////////////////////
-// Parsing
-//////////////////////////////////////////////////////////////////////
-typedef struct GJSON_QueryPotentialMatch
-{
-    char x;
-} GJSON_QueryPotentialMatch;
-
-#define PushParse(Name, _JSONStateType)                                 \
-    static inline JSONParseResult Name##_push(JSONParseData* json_parse_data)       \
-    {                                                                   \
-        json_parse_queue_push(_JSONStateType);                          \
-        JSONParseResult result = Name(json_parse_data);                 \
-        if (result == JSONParseResult_QueryNotDone)                     \
-        {                                                               \
-            json_parse_queue_pop();                                     \
-        }                                                               \
-        return result;                                                  \
+// NOTE: Offset of the first occurrence of needle in data, or size. Compares
+//       the needle's first and last byte 16 positions at a time and only
+//       memcmps where both match.
+static size_t gjson_memmem(const char* data, size_t size, const char* needle, size_t needle_length)
+{
+    if (needle_length == 0)    return 0;
+    if (needle_length > size)  return size;
+    size_t last = size - needle_length;
+    size_t i    = 0;
+#if GJSON_SSE2
+    const __m128i first_char = _mm_set1_epi8(needle[0]);
+    const __m128i last_char  = _mm_set1_epi8(needle[needle_length - 1]);
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i block_last  = _mm_loadu_si128((const __m128i*)(data + i + needle_length - 1));
+        u32 bits = (u32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first_char),
+                                                        _mm_cmpeq_epi8(block_last,  last_char)));
+        for (; bits; bits &= bits - 1)
+        {
+            size_t candidate = i + gjson_lowest_bit_index(bits);
+            if (memcmp(data + candidate + 1, needle + 1, needle_length - 1) == 0) return candidate;
+        }
     }
-
-#define PopParse(Name)                                                  \
-    static inline JSONParseResult Name##_pop(JSONParseData* json_parse_data)        \
-    {                                                                   \
-        JSONParseResult result = Name(json_parse_data);                 \
-        if (result == JSONParseResult_QueryNotDone)                     \
-        {                                                               \
-            json_parse_queue_pop();                                     \
-        }                                                               \
-        return result;                                                  \
+#endif
+    for (; i <= last; i++)
+    {
+        if (data[i] == needle[0] && memcmp(data + i + 1, needle + 1, needle_length - 1) == 0) return i;
     }
+    return size;
+}
 
-// TODO: Unecessary JSON* argument
-static inline JSONParseResult gjson_skip_whitespace(JSONParseData* json_parse_data)
+// NOTE: gjson_find_string_special for data followed by GJSON_PADDING readable
+//       bytes, whole 16 byte loads with no scalar tail
+static inline size_t gjson_find_string_special_padded(const char* data, size_t size)
 {
-    ReturnIfOutOfBytes();
-    while (gj_IsWhitespace(gjson_peek_current_char(json_parse_data)))
+#if GJSON_SSE2
+    const __m128i quote     = _mm_set1_epi8(GJSON_STRING);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control   = _mm_set1_epi8(0x1F);
+    for (size_t i = 0; i < size; i += 16)
     {
-        gjson_feed_current_char(json_parse_data);
-        ReturnIfOutOfBytes();
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i mask  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                  _mm_cmpeq_epi8(chunk, backslash)),
+                                     _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int bits = _mm_movemask_epi8(mask);
+        if (bits) return gj_Min(i + gjson_lowest_bit_index((u32)bits), size);
     }
-    return JSONParseResult_QueryNotDone;
+    return size;
+#else
+    return gjson_find_string_special(data, size);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// Tokenizer DFA
+//////////////////////////////////////////////////////////////////////
+typedef enum JSONCharClass
+{
+    JSONCharClass_Other       = 0,
+    JSONCharClass_Whitespace  = 1,
+    JSONCharClass_ObjectStart = 2,
+    JSONCharClass_ObjectEnd   = 3,
+    JSONCharClass_ArrayStart  = 4,
+    JSONCharClass_ArrayEnd    = 5,
+    JSONCharClass_String      = 6,
+    JSONCharClass_Separator   = 7,
+    JSONCharClass_Colon       = 8,
+    // NOTE: Number and literal chars
+    JSONCharClass_Scalar      = 9,
+    JSONCharClass_Count       = 10
+} JSONCharClass;
+
+typedef enum JSONLexAction
+{
+    JSONLexAction_None       = 0,
+    JSONLexAction_PushObject = 1,
+    JSONLexAction_PushArray  = 2,
+    JSONLexAction_PopObject  = 3,
+    JSONLexAction_PopArray   = 4,
+    JSONLexAction_Separator  = 5,
+    JSONLexAction_KeyStart   = 6,
+    JSONLexAction_ScalarEnd  = 7,
+    JSONLexAction_Error      = 8
+} JSONLexAction;
+
+static const unsigned char gjson_char_classes[256] =
+{
+    [' ']  = JSONCharClass_Whitespace, ['\t'] = JSONCharClass_Whitespace,
+    ['\n'] = JSONCharClass_Whitespace, ['\r'] = JSONCharClass_Whitespace,
+    [GJSON_OBJECT_START]      = JSONCharClass_ObjectStart,
+    [GJSON_OBJECT_END]        = JSONCharClass_ObjectEnd,
+    [GJSON_ARRAY_START]       = JSONCharClass_ArrayStart,
+    [GJSON_ARRAY_END]         = JSONCharClass_ArrayEnd,
+    [GJSON_STRING]            = JSONCharClass_String,
+    [GJSON_ELEMENT_SEPARATOR] = JSONCharClass_Separator,
+    [GJSON_MEMBER_COLON]      = JSONCharClass_Colon,
+    ['0'] = JSONCharClass_Scalar, ['1'] = JSONCharClass_Scalar, ['2'] = JSONCharClass_Scalar,
+    ['3'] = JSONCharClass_Scalar, ['4'] = JSONCharClass_Scalar, ['5'] = JSONCharClass_Scalar,
+    ['6'] = JSONCharClass_Scalar, ['7'] = JSONCharClass_Scalar, ['8'] = JSONCharClass_Scalar,
+    ['9'] = JSONCharClass_Scalar,
+    [GJSON_FRACTION]      = JSONCharClass_Scalar,
+    [GJSON_SIGN_POSITIVE] = JSONCharClass_Scalar,
+    [GJSON_SIGN_NEGATIVE] = JSONCharClass_Scalar,
+    [GJSON_EXPONENT_E]    = JSONCharClass_Scalar,
+    [GJSON_EXPONENT_e]    = JSONCharClass_Scalar,
+    // NOTE: true/false/null
+    ['t'] = JSONCharClass_Scalar, ['r'] = JSONCharClass_Scalar, ['u'] = JSONCharClass_Scalar,
+    ['f'] = JSONCharClass_Scalar, ['a'] = JSONCharClass_Scalar, ['l'] = JSONCharClass_Scalar,
+    ['s'] = JSONCharClass_Scalar, ['n'] = JSONCharClass_Scalar,
+};
+
+// NOTE: Transition byte is (JSONLexAction << 4) | next JSONLexState
+#define T(Action, State) (unsigned char)((JSONLexAction_##Action << 4) | JSONLexState_##State)
+#define E T(Error, Error)
+static const unsigned char gjson_lex_transitions[JSONLexState_TableCount][JSONCharClass_Count] =
+{
+    //                  Other  Whitespace            {                           }                         [                         ]                        "                   ,                     :                Scalar
+    /* Value       */ { E,     T(None, Value),       T(PushObject, ObjectFirst), E,                        T(PushArray, ArrayFirst), E,                       T(None, String),    E,                    E,               T(None, Scalar) },
+    /* ArrayFirst  */ { E,     T(None, ArrayFirst),  T(PushObject, ObjectFirst), E,                        T(PushArray, ArrayFirst), T(PopArray, AfterValue), T(None, String),    E,                    E,               T(None, Scalar) },
+    /* ObjectFirst */ { E,     T(None, ObjectFirst), E,                          T(PopObject, AfterValue), E,                        E,                       T(KeyStart, Key),   E,                    E,               E               },
+    /* ObjectKey   */ { E,     T(None, ObjectKey),   E,                          E,                        E,                        E,                       T(KeyStart, Key),   E,                    E,               E               },
+    /* Colon       */ { E,     T(None, Colon),       E,                          E,                        E,                        E,                       E,                  E,                    T(None, Value),  E               },
+    /* AfterValue  */ { E,     T(None, AfterValue),  E,                          T(PopObject, AfterValue), E,                        T(PopArray, AfterValue), E,                  T(Separator, Value),  E,               E               },
+    /* Scalar      */ { E,     T(ScalarEnd, AfterValue), E,                      T(PopObject, AfterValue), E,                        T(PopArray, AfterValue), E,                  T(Separator, Value),  E,               T(None, Scalar) },
+    /* Error       */ { E,     E,                    E,                          E,                        E,                        E,                       E,                  E,                    E,               E               },
+};
+#undef E
+#undef T
+
+static inline unsigned char gjson_parse_queue_top(JSONParseQueue* json_parse_queue)
+{
+    return json_parse_queue->count > 0 ? json_parse_queue->queue[json_parse_queue->count - 1] : JSONStateType_Undefined;
 }
-PushParse(gjson_skip_whitespace, JSONStateType_SkipWhitespace)
-PopParse(gjson_skip_whitespace)
 
-static JSONParseResult gjson_parse_object(JSONParseData* json_parse_data)
+// NOTE: After a complete value, top-level goes straight back to Value (NDJSON)
+static inline unsigned char gjson_lex_state_after_value(JSONParseQueue* json_parse_queue)
 {
-    JSONParseState* current = json_parse_queue_current();
-    while (gj_True)
-    {
-        if (current->state == JSONObjectState_Start)
-        {
-            gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_OBJECT_START);
-            gjson_feed_current_char(json_parse_data);
-            current->state = JSONObjectState_End;
-            gjson_skip_whitespace_push(json_parse_data);
-            
-        }
+    return json_parse_queue->count > 0 ? JSONLexState_AfterValue : JSONLexState_Value;
+}
 
-        if (current->state == JSONObjectState_End)
-        {
-            ReturnIfOutOfBytes();
-            if (gjson_peek_current_char(json_parse_data) == GJSON_OBJECT_END)
-            {
-                gjson_feed_current_char(json_parse_data);
-                return JSONParseResult_QueryNotDone;
-            }
-            else
-            {
-                current->state = JSONObjectState_KeyBefore;
-            }
-        }
-        
-        if (current->state == JSONObjectState_KeyBefore)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_Key;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
+// NOTE: Between top-level values, used by prefilters to skip ahead
+static inline int gjson_parse_queue_at_top_level(JSONParseQueue* json_parse_queue)
+{
+    return json_parse_queue->count == 0 && json_parse_queue->state == JSONLexState_Value;
+}
 
-        if (current->state == JSONObjectState_Key)
+// NOTE: Every value so far is complete, nothing is left open
+static inline int gjson_parse_queue_complete(JSONParseQueue* json_parse_queue)
+{
+    return json_parse_queue->count == 0 &&
+           (json_parse_queue->state == JSONLexState_Value || json_parse_queue->state == JSONLexState_Scalar);
+}
+
+static inline void gjson_parse_queue_clear(JSONParseQueue* json_parse_queue)
+{
+    json_parse_queue->count = 0;
+    json_parse_queue->state = JSONLexState_Value;
+}
+
+static JSONParseResult gjson_parse(JSONParseData* json_parse_data)
+{
+    JSONParseQueue* queue  = json_parse_data->parse_queue;
+    const char*     data   = json_parse_data->data;
+    size_t          size   = json_parse_data->size;
+    size_t          cursor = json_parse_data->cursor;
+    unsigned char   state  = queue->state;
+
+    while (cursor < size)
+    {
+        if (state < JSONLexState_TableCount)
         {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_KeyAfter;
-            int   match_length = 0;
-            char* match        = NULL;
-            if (json_parse_data->query.type == GJSON_QueryType_ObjectKey)
+            unsigned char c          = (unsigned char)data[cursor];
+            unsigned char transition = gjson_lex_transitions[state][gjson_char_classes[c]];
+            state = transition & 0xF;
+            switch (transition >> 4)
             {
-                match_length = json_parse_data->query.string_length;
-                match        = json_parse_data->query.string;
-            }
-            JSONParseResult result = gjson_parse_string_push(json_parse_data, match, match_length);
-            if (result == JSONParseResult_QueryDone) return result;
-        }
+                case JSONLexAction_None: break;
 
-        if (current-> state == JSONObjectState_KeyAfter)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_Colon;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
-        
-        if (current->state == JSONObjectState_Colon)
-        {
-            ReturnIfOutOfBytes();
-            gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_MEMBER_COLON);
-            gjson_feed_current_char(json_parse_data);
-            current->state = JSONObjectState_ValueBefore;
-        }
+                case JSONLexAction_PushObject:
+                case JSONLexAction_PushArray:
+                {
+                    if (queue->count == JSON_PARSE_QUEUE_SIZE) goto error;
+                    queue->queue[queue->count++] = (transition >> 4) == JSONLexAction_PushObject ? JSONStateType_Object : JSONStateType_Array;
+                } break;
 
-        if (current->state == JSONObjectState_ValueBefore)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_Value;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
+                case JSONLexAction_PopObject:
+                case JSONLexAction_PopArray:
+                {
+                    unsigned char expected = (transition >> 4) == JSONLexAction_PopObject ? JSONStateType_Object : JSONStateType_Array;
+                    if (gjson_parse_queue_top(queue) != expected) goto error;
+                    queue->count--;
+                    state = gjson_lex_state_after_value(queue);
+                } break;
 
-        if (current->state == JSONObjectState_Value)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_ValueAfter;
-            JSONParseResult result = gjson_parse_value(json_parse_data);
-            if (result == JSONParseResult_QueryDone) return result;
-        }
+                case JSONLexAction_Separator:
+                {
+                    unsigned char top = gjson_parse_queue_top(queue);
+                    if (top == JSONStateType_Undefined) goto error;
+                    state = top == JSONStateType_Object ? JSONLexState_ObjectKey : JSONLexState_Value;
+                } break;
 
-        if (current->state == JSONObjectState_ValueAfter)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONObjectState_CheckNext;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
-        
-        if (current->state == JSONObjectState_CheckNext)
-        {
-            ReturnIfOutOfBytes();
-        
-            if (gjson_peek_current_char(json_parse_data) == GJSON_ELEMENT_SEPARATOR)
-            {
-                gjson_feed_current_char(json_parse_data);
-                current->state = JSONObjectState_KeyBefore;
-            }
-            else
-            {
-                gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_OBJECT_END);
-                gjson_feed_current_char(json_parse_data);
-                return JSONParseResult_QueryNotDone;
-            }
-        }
-    }
-}
-PushParse(gjson_parse_object, JSONStateType_Object)
-PopParse(gjson_parse_object)
+                case JSONLexAction_KeyStart:
+                {
+                    queue->string_match  = (u32)(((u64)1 << json_parse_data->key_count) - 1);
+                    queue->string_cursor = 0;
+                    json_parse_data->match_start = cursor;
+                } break;
 
-static JSONParseResult gjson_parse_array(JSONParseData* json_parse_data)
-{
-    JSONParseState* current = json_parse_queue_current();
-    while (gj_True)
-    {
-        if (current->state == JSONArrayState_Start)
-        {
-            gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_ARRAY_START);
-            gjson_feed_current_char(json_parse_data);
-            current->state = JSONArrayState_End;
-        }
+                case JSONLexAction_ScalarEnd:
+                {
+                    state = gjson_lex_state_after_value(queue);
+                } break;
 
-        if (current->state == JSONArrayState_End)
-        {
-            ReturnIfOutOfBytes();
-            
-            if (gjson_peek_current_char(json_parse_data) == GJSON_ARRAY_END)
-            {
-                gjson_feed_current_char(json_parse_data);
-                return JSONParseResult_QueryNotDone;
-            }
-            else
-            {
-                current->state = JSONArrayState_ValueBefore;
+                default: goto error;
             }
+            cursor++;
+            continue;
         }
 
-        if (current->state == JSONArrayState_ValueBefore)
+        switch (state)
         {
-            ReturnIfOutOfBytes();
-            current->state = JSONArrayState_Value;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
+            case JSONLexState_String:
+            {
+                cursor += gjson_find_string_special(data + cursor, size - cursor);
+                if (cursor == size) break;
 
-        if (current->state == JSONArrayState_Value)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONArrayState_ValueAfter;
-            JSONParseResult result = gjson_parse_value(json_parse_data);
-            if (result == JSONParseResult_QueryDone) return result;
-        }
+                char c = data[cursor++];
+                if      (c == GJSON_STRING) state = gjson_lex_state_after_value(queue);
+                else if (c == '\\')         state = JSONLexState_StringEscape;
+            } break;
 
-        if (current->state == JSONArrayState_ValueAfter)
-        {
-            ReturnIfOutOfBytes();
-            current->state = JSONArrayState_CheckNext;
-            gjson_skip_whitespace_push(json_parse_data);
-        }
-        
-        if (current->state == JSONArrayState_CheckNext)
-        {
-            ReturnIfOutOfBytes();
-            if (gjson_peek_current_char(json_parse_data) == GJSON_ELEMENT_SEPARATOR)
-            {
-                gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_ELEMENT_SEPARATOR);
-                gjson_feed_current_char(json_parse_data);
-                current->state = JSONArrayState_ValueBefore;
-            }
-            else
+            case JSONLexState_Key:
             {
-                gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_ARRAY_END);
-                gjson_feed_current_char(json_parse_data);
-                return JSONParseResult_QueryNotDone;
-            }
-        }
-    }
-    InvalidCodePath;
-    return JSONParseResult_QueryNotDone;
-}
-PushParse(gjson_parse_array, JSONStateType_Array)
-PopParse(gjson_parse_array)
+                u32 match = queue->string_match;
+                if (!match)
+                {
+                    cursor += gjson_find_string_special(data + cursor, size - cursor);
+                    if (cursor == size) break;
 
-static JSONParseResult gjson_parse_string(JSONParseData* json_parse_data, const char* match, int match_length)
-{
-    JSONParseState* current = json_parse_queue_current();
-    
-    if (current->state == JSONStringState_Start)
-    {
-        gj_Assert(gjson_peek_current_char(json_parse_data) == GJSON_STRING);
-        gjson_feed_current_char(json_parse_data);
+                    char c = data[cursor++];
+                    if      (c == GJSON_STRING) state = JSONLexState_Colon;
+                    else if (c == '\\')         state = JSONLexState_KeyEscape;
+                    break;
+                }
 
-        unsigned int remaining_bytes = gjson_get_remaining_bytes(json_parse_data);
-        char* current_cursor = gjson_get_current_cursor(json_parse_data);
-        if (remaining_bytes > match_length &&
-            memcmp(match, current_cursor, match_length) == 0)
-        {
-            json_parse_queue_pop();
-            return JSONParseResult_QueryDone;
-        }
-        else if (memcmp(match, current_cursor, remaining_bytes) == 0)
-        {
-            /* current->state        = remaining_bytes; */
-        }
-    }
-    
-    while (gj_True)
-    {
-        ReturnIfOutOfBytes();
-        
-        if (current->state == JSONStringState_Char)
-        {        
-            while (gj_True)
-            {
-                ReturnIfOutOfBytes();
-                
-                char current_char = gjson_feed_current_char(json_parse_data);
-                if (current_char == GJSON_STRING)
+                char c = data[cursor++];
+                if (c == GJSON_STRING)
                 {
-                    if (current->string_match && (current->string_cursor == json_parse_data->query.string_length))
+                    state = JSONLexState_Colon;
+                    for (; match; match &= match - 1)
                     {
-                        json_parse_queue_pop();
-                        return JSONParseResult_QueryDone;
+                        int key_index = gjson_lowest_bit_index(match);
+                        if (json_parse_data->keys[key_index].string_length == queue->string_cursor)
+                        {
+                            if (json_parse_data->count_hits)
+                            {
+                                json_parse_data->hit_count++;
+                                break;
+                            }
+                            queue->state = state;
+                            json_parse_data->cursor          = cursor;
+                            json_parse_data->match_key_index = key_index;
+                            return JSONParseResult_QueryDone;
+                        }
                     }
-                    else return JSONParseResult_QueryNotDone;
                 }
-                else if (current_char == '\\')
+                else if (c == '\\')
                 {
-                    current->state = JSONStringState_Backslash;
-                    break;
+                    // NOTE: Escaped keys are never matched
+                    queue->string_match = 0;
+                    state = JSONLexState_KeyEscape;
                 }
-
-                if (current->string_match && json_parse_data->query.type == GJSON_QueryType_String)
+                else
                 {
-                    if (json_parse_data->query.string_length < current->string_cursor ||
-                        json_parse_data->query.string[current->string_cursor] != current_char)
+                    for (u32 candidates = match; candidates; candidates &= candidates - 1)
                     {
-                        current->string_match = gj_False;
+                        int key_index = gjson_lowest_bit_index(candidates);
+                        GJSON_QueryKey* key = &json_parse_data->keys[key_index];
+                        if (key->string_length <= queue->string_cursor ||
+                            key->string[queue->string_cursor] != c)
+                        {
+                            match &= ~(1u << key_index);
+                        }
                     }
+                    queue->string_match = match;
+                    // NOTE: Only counted while matching so strings > 2 GB can't overflow it
+                    if (match) queue->string_cursor++;
                 }
-                else current->string_match = gj_False;
-                current->string_cursor++;
-            }
-        }
+            } break;
 
-        if (current->state == JSONStringState_Backslash)
-        {
-            ReturnIfOutOfBytes();
-            
-            char current_char = gjson_feed_current_char(json_parse_data);
-            current->state = JSONStringState_Char;
+            case JSONLexState_KeyEscape:
+            {
+                cursor++;
+                state = JSONLexState_Key;
+            } break;
+
+            case JSONLexState_StringEscape:
+            {
+                cursor++;
+                state = JSONLexState_String;
+            } break;
 
-            current->string_cursor++;
+            InvalidDefaultCase;
         }
     }
-}
-PushParse(gjson_parse_string, JSONStateType_String)
-PopParse(gjson_parse_string)
 
-static JSONParseResult gjson_parse_number(JSONParseData* json_parse_data)
-{
-    JSONParseState* current = json_parse_queue_current();
+    queue->state = state;
+    json_parse_data->cursor = cursor;
+    return JSONParseResult_OutOfBytes;
 
-    if (current->state == JSONNumberState_IntegerSign)
-    {
-        if (gjson_peek_current_char(json_parse_data) == GJSON_SIGN_NEGATIVE)
-        {
-            // TODO
-            gjson_feed_current_char(json_parse_data);
-        }
-        current->state = JSONNumberState_Integer;
-    }
+error:
+    queue->state = JSONLexState_Error;
+    json_parse_data->cursor = cursor;
+    return JSONParseResult_Error;
+}
 
-    if (current->state == JSONNumberState_Integer)
+// NOTE: Non-resumable skip over the value at cursor, returns the cursor just
+//       past it. complete is cleared if data ends inside a string or container.
+static size_t gjson_skip_value_bytes(const char* data, size_t size, size_t cursor, int* complete)
+{
+    *complete = gj_True;
+    int depth = 0;
+    while (cursor < size)
     {
-        while (gj_IsDigit(gjson_peek_current_char(json_parse_data)))
+        char c = data[cursor];
+        if (c == GJSON_STRING)
         {
-            // TODO
-            gjson_feed_current_char(json_parse_data);
-            ReturnIfOutOfBytes();
+            cursor++;
+            while (cursor < size && data[cursor] != GJSON_STRING)
+            {
+                if (data[cursor] == '\\') cursor++;
+                cursor++;
+            }
+            if (cursor >= size) break;
+            cursor++;
+            if (depth == 0) return cursor;
         }
-        current->state = JSONNumberState_Fraction;
-    }
-
-    if (current->state == JSONNumberState_Fraction)
-    {
-        if (gjson_peek_current_char(json_parse_data) == GJSON_FRACTION)
+        else if (c == GJSON_OBJECT_START || c == GJSON_ARRAY_START)
         {
-            // TODO
-            gjson_feed_current_char(json_parse_data);
-            current->state = JSONNumberState_FractionInteger;
+            depth++;
+            cursor++;
         }
-        else
+        else if (c == GJSON_OBJECT_END || c == GJSON_ARRAY_END)
         {
-            current->state = JSONNumberState_Exponent;
+            if (depth == 0) return cursor;
+            cursor++;
+            if (--depth == 0) return cursor;
         }
-    }
-    
-    if (current->state == JSONNumberState_FractionInteger)
-    {
-        while (gj_IsDigit(gjson_peek_current_char(json_parse_data)))
+        else if (depth == 0)
         {
-            // TODO
-            gjson_feed_current_char(json_parse_data);
-            ReturnIfOutOfBytes();
+            // NOTE: Number or literal
+            while (cursor < size &&
+                   data[cursor] != GJSON_ELEMENT_SEPARATOR &&
+                   data[cursor] != GJSON_OBJECT_END &&
+                   data[cursor] != GJSON_ARRAY_END &&
+                   !gj_IsWhitespace(data[cursor]))
+            {
+                cursor++;
+            }
+            return cursor;
         }
-        current->state = JSONNumberState_Exponent;
+        else cursor++;
     }
+    *complete = gj_False;
+    return size;
+}
 
-    if (current->state == JSONNumberState_Exponent)
-    {
-        if (gjson_peek_current_char(json_parse_data) == GJSON_EXPONENT_e ||
-            gjson_peek_current_char(json_parse_data) == GJSON_EXPONENT_E)
-        {
-            gj_Assert(gj_False);
-            current->state = JSONNumberState_ExponentSign;
-        }
-        else
-        {
-            return JSONParseResult_QueryNotDone;
-        }
-    }
-    
-    if (current->state == JSONNumberState_ExponentSign)
-    {
-        if (gjson_feed_current_char(json_parse_data) == GJSON_SIGN_NEGATIVE)
-        {
-            // TODO
-        }
-        current->state = JSONNumberState_ExponentInteger;
-    }
-    
-    if (current->state == JSONNumberState_ExponentInteger)
-    {
-        // TODO
-        gj_Assert(gj_False);
-    }
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_State gjson_init(void* memory, size_t memory_size)
+{
+    GJSON_State result;
+    gj_ZeroMemory(&result);
+    initialize_arena(&result.memory_arena, memory_size, (u8*)memory);
+    result.parse_queue = PushStruct(&result.memory_arena, JSONParseQueue);
+    gjson_parse_queue_clear(result.parse_queue);
+    result.memory_base_used       = result.memory_arena.used;
+    result.memory_high_water_mark = result.memory_arena.used;
+    return result;
+}
 
-    return JSONParseResult_QueryNotDone;
+static size_t gjson_minimum_memory_size()
+{
+    // NOTE: Slack for arena alignment
+    return sizeof(JSONParseQueue) + 64;
+}
+
+static GJSON_State gjson_init_sub_state(GJSON_State* parent, size_t memory_size)
+{
+    gj_Assert(memory_size >= gjson_minimum_memory_size());
+    return gjson_init(PushSize(&parent->memory_arena, memory_size), memory_size);
 }
-PushParse(gjson_parse_number, JSONStateType_Number)
-PopParse(gjson_parse_number)
 
-static JSONParseResult gjson_parse_literal_push(JSONParseData* json_parse_data, JSONStateType type, int literal_size)
+static inline void gjson_update_high_water_mark(GJSON_State* gjson)
 {
-    json_parse_queue_push(type);
-    unsigned int remaining_bytes = gjson_get_remaining_bytes(json_parse_data);
-    if (remaining_bytes > literal_size)
+    if (gjson->memory_arena.used > gjson->memory_high_water_mark)
     {
-        json_parse_data->cursor += literal_size;
-        json_parse_queue_pop();
-        return JSONParseResult_QueryNotDone;
+        gjson->memory_high_water_mark = gjson->memory_arena.used;
     }
-    else
-    {
-        JSONParseState* parse_state = json_parse_queue_current();
-        parse_state->state = literal_size - remaining_bytes;
-        json_parse_data->cursor += remaining_bytes;
-        return JSONParseResult_OutOfBytes;
-    }    
 }
 
-static JSONParseResult gjson_parse_literal_pop(JSONParseData* json_parse_data)
+static void gjson_reset(GJSON_State* gjson)
+{
+    gjson_update_high_water_mark(gjson);
+    gjson->memory_arena.used = gjson->memory_base_used;
+    gjson_parse_queue_clear(gjson->parse_queue);
+}
+
+static GJSON_Checkpoint gjson_checkpoint(GJSON_State* gjson)
+{
+    JSONParseQueue*  queue = gjson->parse_queue;
+    GJSON_Checkpoint result;
+    result.memory_used       = gjson->memory_arena.used;
+    result.parse_queue_count = queue->count;
+    result.parse_state       = queue->state;
+    result.string_match      = queue->string_match;
+    result.string_cursor     = queue->string_cursor;
+    memcpy(result.parse_queue, queue->queue, queue->count);
+    return result;
+}
+
+static void gjson_rollback(GJSON_State* gjson, GJSON_Checkpoint checkpoint)
+{
+    gj_Assert(checkpoint.memory_used <= gjson->memory_arena.used);
+    JSONParseQueue* queue = gjson->parse_queue;
+    gjson_update_high_water_mark(gjson);
+    gjson->memory_arena.used = checkpoint.memory_used;
+    queue->count             = checkpoint.parse_queue_count;
+    queue->state             = checkpoint.parse_state;
+    queue->string_match      = checkpoint.string_match;
+    queue->string_cursor     = checkpoint.string_cursor;
+    memcpy(queue->queue, checkpoint.parse_queue, checkpoint.parse_queue_count);
+}
+
+static size_t gjson_memory_high_water_mark(GJSON_State* gjson)
+{
+    gjson_update_high_water_mark(gjson);
+    return gjson->memory_high_water_mark;
+}
+
+// NOTE: single_key backs the key set of an ObjectKey query and must outlive
+//       json_parse_data
+static void gjson_parse_data_init(JSONParseData* json_parse_data, GJSON_State* gjson,
+                                  GJSON_Query query, GJSON_QueryKey* single_key)
 {
-    JSONParseState* parse_state = json_parse_queue_current();    
-    unsigned int remaining_bytes = gjson_get_remaining_bytes(json_parse_data);
-    if (remaining_bytes > parse_state->state)
+    gj_ZeroMemory(json_parse_data);
+    json_parse_data->data         = (char*)gjson->data;
+    json_parse_data->size         = gjson->size;
+    json_parse_data->memory_arena = &gjson->memory_arena;
+    json_parse_data->parse_queue  = gjson->parse_queue;
+    json_parse_data->query        = query;
+
+    if (query.type == GJSON_QueryType_ObjectKey)
     {
-        json_parse_data->cursor += parse_state->state;
-        json_parse_queue_pop();
-        return JSONParseResult_QueryNotDone;
+        single_key->string_length  = query.string_length;
+        single_key->string         = query.string;
+        json_parse_data->keys      = single_key;
+        json_parse_data->key_count = 1;
     }
     else
     {
-        parse_state->state = parse_state->state - remaining_bytes;
-        json_parse_data->cursor += remaining_bytes;
-        return JSONParseResult_OutOfBytes;
+        gj_Assert(query.key_count <= GJSON_QUERY_MAX_KEYS);
+        json_parse_data->keys      = query.keys;
+        json_parse_data->key_count = query.key_count;
     }
 }
 
-static JSONParseResult gjson_parse_value(JSONParseData* json_parse_data)
+static GJSON_QueryResult gjson_search(GJSON_State* gjson, GJSON_Query query)
 {
-    ReturnIfOutOfBytes();
-    
-    char current_char = gjson_peek_current_char(json_parse_data);
-    switch (current_char)
+    GJSON_QueryResult result;
+    gj_ZeroMemory(&result);
+
+    JSONParseData  json_parse_data;
+    GJSON_QueryKey single_key;
+    gjson_parse_data_init(&json_parse_data, gjson, query, &single_key);
+
+    switch (gjson_parse(&json_parse_data))
     {
-        case GJSON_OBJECT_START: return gjson_parse_object_push(json_parse_data);
-        case GJSON_ARRAY_START:  return gjson_parse_array_push(json_parse_data);
-        case GJSON_STRING:       return gjson_parse_string_push(json_parse_data);
-        
-        default:
+        case JSONParseResult_OutOfBytes:
         {
-            if (current_char == GJSON_SIGN_NEGATIVE || gj_IsDigit(current_char))
-            {
-                return gjson_parse_number_push(json_parse_data);
-            }
-            else
-            {
-                if (current_char == 't')
-                {
-                    return gjson_parse_literal_push(json_parse_data, JSONStateType_True, 4);
-                }
-                else if (current_char == 'f')
-                {
-                    return gjson_parse_literal_push(json_parse_data, JSONStateType_False, 5);
-                }
-                else if (current_char == 'n')
-                {
-                    return gjson_parse_literal_push(json_parse_data, JSONStateType_Null, 4);
-                }
-                else InvalidCodePath;
-            }
+            result.type = GJSON_QueryResultType_NeedMoreBytes;
+        } break;
+        case JSONParseResult_QueryDone:
+        {
+            result.type        = GJSON_QueryResultType_Hit;
+            result.match_start = json_parse_data.match_start;
+            result.key_index   = json_parse_data.match_key_index;
+        } break;
+        case JSONParseResult_Error:
+        {
+            result.type = GJSON_QueryResultType_Error;
         } break;
-    }
 
-    InvalidCodePath;
+        InvalidDefaultCase;
+    }
+    result.read_bytes = json_parse_data.cursor;
     
-    return gj_True;
+    return result;
 }
 
-//////////////////////////////////////////////////////////////////////
-// API Implementation
-//////////////////////////////////////////////////////////////////////
-static GJSON_State gjson_init(void* memory, size_t memory_size)
+// NOTE: Cursor just past an opening quote, returns the closing quote's
+//       offset or size. escaped is set if the string has escapes or control chars.
+static inline size_t gjson_small_string_end(const char* data, size_t size, size_t cursor, int* escaped)
 {
-    GJSON_State result;
-    gj_ZeroMemory(&result);
-    initialize_arena(&result.memory_arena, memory_size, (u8*)memory);
-    return result;
+    while (cursor < size)
+    {
+        cursor += gjson_find_string_special_padded(data + cursor, size - cursor);
+        if (cursor >= size || data[cursor] == GJSON_STRING) break;
+        *escaped = gj_True;
+        cursor += data[cursor] == '\\' ? 2 : 1;
+    }
+    return gj_Min(cursor, size);
 }
 
-static GJSON_QueryResult gjson_search(GJSON_State* gjson, GJSON_Query query)
+static int gjson_search_small(const void* data, size_t size, GJSON_Query query,
+                              GJSON_QueryResult* hits, int hit_capacity)
 {
-    GJSON_QueryResult result;
-    gj_ZeroMemory(&result);
-
-    JSONParseData json_parse_data;
-    json_parse_data.data         = (char*)gjson->data;
-    json_parse_data.size         = gjson->size;
-    json_parse_data.cursor       = 0;
-    json_parse_data.memory_arena = &gjson->memory_arena;
-    json_parse_data.query        = query;
-
-#define CheckReturn(Exp)                                                \
-    do {                                                                \
-        switch (Exp)                                                    \
-        {                                                               \
-            case JSONParseResult_OutOfBytes:                            \
-                result.type = GJSON_QueryResultType_NeedMoreBytes;      \
-                result.read_bytes = json_parse_data.cursor;             \
-                return result;                                          \
-            case JSONParseResult_QueryDone:                             \
-                result.type = GJSON_QueryResultType_Hit;                \
-                result.read_bytes = json_parse_data.cursor;             \
-                return result;                                          \
-            case JSONParseResult_QueryNotDone: break;                   \
-                                                                        \
-            InvalidDefaultCase;                                         \
-        }                                                               \
-    } while(gj_False)
-    
-    if (json_parse_queue.count == 0)
+    GJSON_QueryKey  single_key;
+    GJSON_QueryKey* keys      = query.keys;
+    int             key_count = query.key_count;
+    if (query.type == GJSON_QueryType_ObjectKey)
     {
-        CheckReturn(gjson_skip_whitespace_push(&json_parse_data));
-        CheckReturn(gjson_parse_value(&json_parse_data));
-        CheckReturn(gjson_skip_whitespace_push(&json_parse_data));
+        single_key.string_length = query.string_length;
+        single_key.string        = query.string;
+        keys      = &single_key;
+        key_count = 1;
     }
 
-    while (!gjson_out_of_bytes(&json_parse_data) && json_parse_queue.count > 0)
+    const char*    json   = (const char*)data;
+    size_t         cursor = 0;
+    int            result = 0;
+    JSONParseQueue queue;
+    gjson_parse_queue_clear(&queue);
+    unsigned char  state  = JSONLexState_Value;
+
+    while (cursor < size && result < hit_capacity)
     {
-        JSONParseState* current = json_parse_queue_current();
-        switch (current->type)
+        unsigned char c          = (unsigned char)json[cursor++];
+        unsigned char transition = gjson_lex_transitions[state][gjson_char_classes[c]];
+        state = transition & 0xF;
+        switch (transition >> 4)
         {
-            case JSONStateType_SkipWhitespace: CheckReturn(gjson_skip_whitespace_pop(&json_parse_data)); break;
-                
-            case JSONStateType_Value:          CheckReturn(gjson_parse_value(&json_parse_data));      break;
-            case JSONStateType_Object:         CheckReturn(gjson_parse_object_pop(&json_parse_data)); break;
-            case JSONStateType_Array:          CheckReturn(gjson_parse_array_pop(&json_parse_data));  break;
-            case JSONStateType_String:         CheckReturn(gjson_parse_string_pop(&json_parse_data)); break;
-            case JSONStateType_Number:         CheckReturn(gjson_parse_number_pop(&json_parse_data)); break;
-
-            case JSONStateType_True:
-            case JSONStateType_False:
-            case JSONStateType_Null:
+            case JSONLexAction_None: break;
+
+            case JSONLexAction_PushObject:
+            case JSONLexAction_PushArray:
+            {
+                if (queue.count == JSON_PARSE_QUEUE_SIZE) return -1;
+                queue.queue[queue.count++] = (transition >> 4) == JSONLexAction_PushObject ? JSONStateType_Object : JSONStateType_Array;
+            } break;
+
+            case JSONLexAction_PopObject:
+            case JSONLexAction_PopArray:
+            {
+                unsigned char expected = (transition >> 4) == JSONLexAction_PopObject ? JSONStateType_Object : JSONStateType_Array;
+                if (gjson_parse_queue_top(&queue) != expected) return -1;
+                queue.count--;
+                state = gjson_lex_state_after_value(&queue);
+            } break;
+
+            case JSONLexAction_Separator:
+            {
+                unsigned char top = gjson_parse_queue_top(&queue);
+                if (top == JSONStateType_Undefined) return -1;
+                state = top == JSONStateType_Object ? JSONLexState_ObjectKey : JSONLexState_Value;
+            } break;
+
+            case JSONLexAction_KeyStart:
             {
-                CheckReturn(gjson_parse_literal_pop(&json_parse_data));
+                // NOTE: Whole key is scanned first, then compared in one go
+                int    escaped = gj_False;
+                size_t end     = gjson_small_string_end(json, size, cursor, &escaped);
+                if (end == size) return -1;
+                size_t length  = end - cursor;
+                for (int key_index = 0; key_index < key_count && !escaped; key_index++)
+                {
+                    if ((size_t)keys[key_index].string_length == length &&
+                        memcmp(json + cursor, keys[key_index].string, length) == 0)
+                    {
+                        GJSON_QueryResult* hit = &hits[result++];
+                        hit->type        = GJSON_QueryResultType_Hit;
+                        hit->read_bytes  = end + 1;
+                        hit->match_start = cursor - 1;
+                        hit->key_index   = key_index;
+                        break;
+                    }
+                }
+                cursor = end + 1;
+                state  = JSONLexState_Colon;
             } break;
-            
-            default: gj_Assert(gj_False); break;
+
+            case JSONLexAction_ScalarEnd:
+            {
+                state = gjson_lex_state_after_value(&queue);
+            } break;
+
+            default: return -1;
         }
-    }
 
-    if (gjson_out_of_bytes(&json_parse_data))
-    {
-        result.type = GJSON_QueryResultType_NeedMoreBytes;
-        result.read_bytes = json_parse_data.cursor;
+        if (state == JSONLexState_String)
+        {
+            int    escaped = gj_False;
+            size_t end     = gjson_small_string_end(json, size, cursor, &escaped);
+            if (end == size) return -1;
+            cursor = end + 1;
+            state  = gjson_lex_state_after_value(&queue);
+        }
     }
-    else InvalidCodePath;
-    
+
+    // NOTE: Cut off inside a value, unless hit_capacity stopped the scan early
+    queue.state = state;
+    if (cursor == size && !gjson_parse_queue_complete(&queue)) return -1;
     return result;
 }
 
+static GJSON_QueryResultType gjson_skip_member_value(GJSON_State* gjson, GJSON_Span* value)
+{
+    const char* data = (const char*)gjson->data;
+    size_t      size = gjson->size;
+
+    // NOTE: gjson_search returned from the key, expecting its colon
+    JSONParseQueue* queue = gjson->parse_queue;
+    gj_Assert(queue->state == JSONLexState_Colon && gjson_parse_queue_top(queue) == JSONStateType_Object);
+
+    size_t cursor = 0;
+    while (cursor < size && gj_IsWhitespace(data[cursor])) cursor++;
+    if (cursor == size) return GJSON_QueryResultType_NeedMoreBytes;
+    if (data[cursor] != GJSON_MEMBER_COLON) goto error;
+    cursor++;
+    while (cursor < size && gj_IsWhitespace(data[cursor])) cursor++;
+    if (cursor == size) return GJSON_QueryResultType_NeedMoreBytes;
+
+    int    complete;
+    size_t end = gjson_skip_value_bytes(data, size, cursor, &complete);
+    if (end == cursor) goto error;
+    // NOTE: A number or literal could go on in the next bytes
+    int scalar = data[cursor] != GJSON_STRING && data[cursor] != GJSON_OBJECT_START && data[cursor] != GJSON_ARRAY_START;
+    if (!complete || (scalar && end == size)) return GJSON_QueryResultType_NeedMoreBytes;
+
+    value->start = cursor;
+    value->end   = end;
+    queue->state = JSONLexState_AfterValue;
+    return GJSON_QueryResultType_Hit;
+
+error:
+    queue->state = JSONLexState_Error;
+    return GJSON_QueryResultType_Error;
+}
+
 #endif
@@ -0,0 +1,261 @@
+#if !defined(JSON_BATCH_H)
+#define JSON_BATCH_H
+
+#include "json.h"
+#include "json_thread.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef struct GJSON_BatchDocument
+{
+    void*  data;
+    size_t size;
+} GJSON_BatchDocument;
+
+typedef struct GJSON_Batch
+{
+    GJSON_BatchDocument* documents;
+    int                  document_count;
+    GJSON_Query*         queries;
+    int                  query_count;
+    // NOTE: document_count * query_count, hits of queries[q] in documents[d]
+    //       are written to hit_counts[d * query_count + q], GJSON_BATCH_ERROR
+    //       if documents[d] is malformed or cut off
+    u32*                 hit_counts;
+} GJSON_Batch;
+
+#define GJSON_BATCH_ERROR 0xFFFFFFFF
+
+typedef struct GJSON_BatchPool GJSON_BatchPool;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: Pool, worker states and their arena slices are pushed from
+//       gjson->memory_arena. The calling thread is worker 0.
+static GJSON_BatchPool* gjson_batch_pool_init(GJSON_State* gjson, int worker_count, size_t worker_memory_size);
+static void             gjson_batch_search   (GJSON_BatchPool* pool, GJSON_Batch* batch);
+static void             gjson_batch_pool_shutdown(GJSON_BatchPool* pool);
+// NOTE: Largest high water mark of any worker
+static size_t           gjson_batch_pool_high_water_mark(GJSON_BatchPool* pool);
+
+//////////////////////////////////////////////////////////////////////
+// Work stealing
+//////////////////////////////////////////////////////////////////////
+// NOTE: Each worker owns a range of document indices packed as
+//       (end << 32 | begin). The owner takes from the front one document
+//       at a time, thieves CAS away the back half.
+#define GJSON_BATCH_RANGE(Begin, End) (((u64)(End) << 32) | (u64)(Begin))
+#define GJSON_BATCH_RANGE_BEGIN(Range) ((u32)(Range))
+#define GJSON_BATCH_RANGE_END(Range)   ((u32)((Range) >> 32))
+
+typedef struct GJSON_BatchWorker
+{
+    // NOTE: Own cache line, written by owner and thieves
+    volatile u64 range;
+    char         pad[64 - sizeof(u64)];
+
+    GJSON_State      state;
+    GJSON_BatchPool* pool;
+    int              index;
+    GJSON_Thread     thread;
+} GJSON_BatchWorker;
+
+struct GJSON_BatchPool
+{
+    GJSON_BatchWorker* workers;
+    int                worker_count;
+
+    GJSON_Batch*    batch;
+    GJSON_Mutex     mutex;
+    GJSON_Condition start_condition;
+    GJSON_Condition done_condition;
+    u32             generation;
+    int             busy_workers;
+    int             quit;
+};
+
+static int gjson_batch_pop(GJSON_BatchWorker* worker, u32* document_index)
+{
+    while (gj_True)
+    {
+        u64 range = gjson_atomic_load_u64(&worker->range);
+        u32 begin = GJSON_BATCH_RANGE_BEGIN(range);
+        u32 end   = GJSON_BATCH_RANGE_END(range);
+        if (begin >= end) return gj_False;
+        if (gjson_atomic_cas_u64(&worker->range, range, GJSON_BATCH_RANGE(begin + 1, end)))
+        {
+            *document_index = begin;
+            return gj_True;
+        }
+    }
+}
+
+static int gjson_batch_steal(GJSON_BatchWorker* worker)
+{
+    GJSON_BatchPool* pool = worker->pool;
+    for (int i = 1; i < pool->worker_count; i++)
+    {
+        GJSON_BatchWorker* victim = &pool->workers[(worker->index + i) % pool->worker_count];
+        while (gj_True)
+        {
+            u64 range = gjson_atomic_load_u64(&victim->range);
+            u32 begin = GJSON_BATCH_RANGE_BEGIN(range);
+            u32 end   = GJSON_BATCH_RANGE_END(range);
+            if (begin >= end) break;
+
+            u32 middle = begin + (end - begin) / 2;
+            if (gjson_atomic_cas_u64(&victim->range, range, GJSON_BATCH_RANGE(begin, middle)))
+            {
+                // NOTE: Our range is empty so nobody else writes it right now
+                gjson_atomic_store_u64(&worker->range, GJSON_BATCH_RANGE(middle, end));
+                return gj_True;
+            }
+        }
+    }
+    return gj_False;
+}
+
+static void gjson_batch_search_document(GJSON_State* state, GJSON_BatchDocument* document,
+                                        GJSON_Query* queries, int query_count, u32* hit_counts)
+{
+    GJSON_Checkpoint checkpoint = gjson_checkpoint(state);
+    for (int query_index = 0; query_index < query_count; query_index++)
+    {
+        u32    hits   = 0;
+        size_t offset = 0;
+        while (offset < document->size)
+        {
+            state->data = (char*)document->data + offset;
+            state->size = document->size - offset;
+            GJSON_QueryResult result = gjson_search(state, queries[query_index]);
+            offset += result.read_bytes;
+            if (result.type != GJSON_QueryResultType_Hit) break;
+            hits++;
+        }
+        // NOTE: Errors are sticky, a document that merely ends early leaves
+        //       the parse stack incomplete
+        if (!gjson_parse_queue_complete(state->parse_queue)) hits = GJSON_BATCH_ERROR;
+        hit_counts[query_index] = hits;
+        gjson_rollback(state, checkpoint);
+    }
+}
+
+static void gjson_batch_work(GJSON_BatchWorker* worker)
+{
+    GJSON_Batch* batch = worker->pool->batch;
+    u32 document_index;
+    do
+    {
+        while (gjson_batch_pop(worker, &document_index))
+        {
+            gjson_batch_search_document(&worker->state, &batch->documents[document_index],
+                                        batch->queries, batch->query_count,
+                                        &batch->hit_counts[(size_t)document_index * batch->query_count]);
+        }
+    } while (gjson_batch_steal(worker));
+}
+
+static GJSON_THREAD_PROC(gjson_batch_thread_proc)
+{
+    GJSON_BatchWorker* worker = (GJSON_BatchWorker*)parameter;
+    GJSON_BatchPool*   pool   = worker->pool;
+    u32 seen_generation = 0;
+
+    gjson_mutex_lock(&pool->mutex);
+    while (gj_True)
+    {
+        while (!pool->quit && pool->generation == seen_generation)
+        {
+            gjson_condition_wait(&pool->start_condition, &pool->mutex);
+        }
+        if (pool->quit) break;
+        seen_generation = pool->generation;
+        gjson_mutex_unlock(&pool->mutex);
+
+        gjson_batch_work(worker);
+
+        gjson_mutex_lock(&pool->mutex);
+        if (--pool->busy_workers == 0) gjson_condition_broadcast(&pool->done_condition);
+    }
+    gjson_mutex_unlock(&pool->mutex);
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_BatchPool* gjson_batch_pool_init(GJSON_State* gjson, int worker_count, size_t worker_memory_size)
+{
+    gj_Assert(worker_count > 0);
+    GJSON_BatchPool* pool = PushStruct(&gjson->memory_arena, GJSON_BatchPool);
+    gj_ZeroMemory(pool);
+    pool->worker_count = worker_count;
+    pool->workers      = PushArray(&gjson->memory_arena, worker_count, GJSON_BatchWorker);
+    gjson_mutex_init(&pool->mutex);
+    gjson_condition_init(&pool->start_condition);
+    gjson_condition_init(&pool->done_condition);
+
+    for (int i = 0; i < worker_count; i++)
+    {
+        GJSON_BatchWorker* worker = &pool->workers[i];
+        gj_ZeroMemory(worker);
+        worker->pool  = pool;
+        worker->index = i;
+        worker->state = gjson_init_sub_state(gjson, worker_memory_size);
+    }
+    for (int i = 1; i < worker_count; i++)
+    {
+        pool->workers[i].thread = gjson_thread_create(gjson_batch_thread_proc, &pool->workers[i]);
+    }
+    return pool;
+}
+
+static void gjson_batch_search(GJSON_BatchPool* pool, GJSON_Batch* batch)
+{
+    gj_Assert(batch->document_count >= 0);
+    u32 document_count = (u32)batch->document_count;
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        u32 begin = (u32)(((u64)document_count * i)       / pool->worker_count);
+        u32 end   = (u32)(((u64)document_count * (i + 1)) / pool->worker_count);
+        gjson_atomic_store_u64(&pool->workers[i].range, GJSON_BATCH_RANGE(begin, end));
+    }
+
+    gjson_mutex_lock(&pool->mutex);
+    pool->batch        = batch;
+    pool->busy_workers = pool->worker_count - 1;
+    pool->generation++;
+    gjson_condition_broadcast(&pool->start_condition);
+    gjson_mutex_unlock(&pool->mutex);
+
+    gjson_batch_work(&pool->workers[0]);
+
+    gjson_mutex_lock(&pool->mutex);
+    while (pool->busy_workers > 0) gjson_condition_wait(&pool->done_condition, &pool->mutex);
+    pool->batch = NULL;
+    gjson_mutex_unlock(&pool->mutex);
+}
+
+static void gjson_batch_pool_shutdown(GJSON_BatchPool* pool)
+{
+    gjson_mutex_lock(&pool->mutex);
+    pool->quit = gj_True;
+    gjson_condition_broadcast(&pool->start_condition);
+    gjson_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->worker_count; i++) gjson_thread_join(pool->workers[i].thread);
+}
+
+static size_t gjson_batch_pool_high_water_mark(GJSON_BatchPool* pool)
+{
+    size_t result = 0;
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        result = gj_Max(result, gjson_memory_high_water_mark(&pool->workers[i].state));
+    }
+    return result;
+}
+
+#endif
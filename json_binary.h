@@ -0,0 +1,705 @@
+#if !defined(JSON_BINARY_H)
+#define JSON_BINARY_H
+
+#include <stdlib.h>
+
+#include "json.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+// NOTE: Little-endian, position independent so an encoded file can be
+//       mmapped and queried in place:
+//
+//       Header  u32 magic, u32 version, u64 root offset, u64 size
+//       Null/False/True  u8 tag
+//       Integer          u8 tag, i64
+//       Double           u8 tag, f64
+//       String           u8 tag, u32 length, raw bytes between the quotes
+//       Array            u8 tag, u32 count, u64 value offset[count]
+//       Object           u8 tag, u32 count, {u64 key offset, u64 value offset}[count]
+//
+//       Records are written children first, object members are sorted by key
+//       bytes (then length) and keys point to String records shared by every
+//       object using that key.
+#define GJSON_BINARY_MAGIC   0x31424A47 // NOTE: "GJB1"
+#define GJSON_BINARY_VERSION 1
+
+typedef enum GJSON_BinaryType
+{
+    GJSON_BinaryType_None,
+    GJSON_BinaryType_Null,
+    GJSON_BinaryType_False,
+    GJSON_BinaryType_True,
+    GJSON_BinaryType_Integer,
+    GJSON_BinaryType_Double,
+    GJSON_BinaryType_String,
+    GJSON_BinaryType_Array,
+    GJSON_BinaryType_Object
+} GJSON_BinaryType;
+
+// NOTE: Offset of a record, 0 (the header) is no value
+typedef u64 GJSON_BinaryValue;
+
+typedef struct GJSON_Binary
+{
+    const u8*         data;
+    size_t            size;
+    GJSON_BinaryValue root;
+} GJSON_Binary;
+
+typedef struct GJSON_BinarySearchFrame
+{
+    GJSON_BinaryValue container;
+    u32               index;
+    int               key_index;
+} GJSON_BinarySearchFrame;
+
+// NOTE: Zero before the first gjson_binary_search
+typedef struct GJSON_BinarySearch
+{
+    int                     depth;
+    int                     done;
+    GJSON_BinarySearchFrame stack[JSON_PARSE_QUEUE_SIZE];
+} GJSON_BinarySearch;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: Encodes one complete JSON value into output, returns the encoded size
+//       or 0 on malformed input or if output_size is too small. Needs at least
+//       JSON_BINARY_KEY_TABLE_SIZE * sizeof(JSONBinaryKey) of gjson->memory_arena
+//       for key interning, the rest holds member tables. Freed on return.
+static size_t gjson_binary_encode(GJSON_State* gjson, const void* json, size_t json_size,
+                                  void* output, size_t output_size);
+// NOTE: gj_False if data isn't an encoded document
+static int    gjson_binary_open(GJSON_Binary* binary, const void* data, size_t size);
+
+// NOTE: Offsets read from data are checked against size, so a corrupt or
+//       truncated file reads as None, 0 or NULL (length 0) instead of past it
+static GJSON_BinaryType  gjson_binary_type   (GJSON_Binary* binary, GJSON_BinaryValue value);
+// NOTE: Array elements or object members
+static u32               gjson_binary_count  (GJSON_Binary* binary, GJSON_BinaryValue value);
+static GJSON_BinaryValue gjson_binary_element(GJSON_Binary* binary, GJSON_BinaryValue array, u32 index);
+static GJSON_BinaryValue gjson_binary_member (GJSON_Binary* binary, GJSON_BinaryValue object, u32 index, GJSON_BinaryValue* key);
+// NOTE: Binary search of the member table, O(log count)
+static GJSON_BinaryValue gjson_binary_get    (GJSON_Binary* binary, GJSON_BinaryValue object, const char* key, int key_length);
+static s64               gjson_binary_integer(GJSON_Binary* binary, GJSON_BinaryValue value);
+// NOTE: Integers are converted
+static f64               gjson_binary_double (GJSON_Binary* binary, GJSON_BinaryValue value);
+static const char*       gjson_binary_string (GJSON_Binary* binary, GJSON_BinaryValue value, u32* length);
+// NOTE: Same hits as gjson_search would find in the text, one per call, with
+//       each object's hits in query key order (a duplicated key hits once).
+//       Every object is visited but keys are found by gjson_binary_get rather
+//       than by comparing each member.
+static int gjson_binary_search(GJSON_Binary* binary, GJSON_BinarySearch* search, GJSON_Query query,
+                               GJSON_BinaryValue* value, int* key_index);
+
+//////////////////////////////////////////////////////////////////////
+// Encoder
+//////////////////////////////////////////////////////////////////////
+#define GJSON_BINARY_HEADER_SIZE (2 * sizeof(u32) + 2 * sizeof(u64))
+
+typedef struct JSONBinaryEntry
+{
+    const char* key;
+    u32         key_length;
+    u64         key_offset;
+    u64         value_offset;
+} JSONBinaryEntry;
+
+// NOTE: Open addressing, a key's String record is written once and shared
+#define JSON_BINARY_KEY_TABLE_SIZE 4096
+typedef struct JSONBinaryKey
+{
+    const char* key;
+    u32         key_length;
+    u64         key_offset;
+} JSONBinaryKey;
+
+typedef struct JSONBinaryEncoder
+{
+    const char* data;
+    size_t      size;
+    size_t      cursor;
+
+    u8*    output;
+    size_t output_size;
+    size_t output_used;
+
+    // NOTE: Members of every open object, each object's on top of its parent's
+    JSONBinaryEntry* entries;
+    size_t           entry_capacity;
+    size_t           entry_count;
+    // NOTE: Most entries in use at once, what the high water mark reports
+    size_t           entry_peak;
+
+    JSONBinaryKey* key_table;
+    int            key_table_count;
+
+    int depth;
+    int error;
+} JSONBinaryEncoder;
+
+static int gjson_binary_key_compare(const char* a, u32 a_length, const char* b, u32 b_length)
+{
+    int result = memcmp(a, b, gj_Min(a_length, b_length));
+    if (result == 0) result = (a_length > b_length) - (a_length < b_length);
+    return result;
+}
+
+static int gjson_binary_entry_compare(const void* a, const void* b)
+{
+    const JSONBinaryEntry* entry_a = (const JSONBinaryEntry*)a;
+    const JSONBinaryEntry* entry_b = (const JSONBinaryEntry*)b;
+    return gjson_binary_key_compare(entry_a->key, entry_a->key_length, entry_b->key, entry_b->key_length);
+}
+
+static void gjson_binary_put(JSONBinaryEncoder* encoder, const void* data, size_t size)
+{
+    if (encoder->output_size - encoder->output_used < size)
+    {
+        encoder->error = gj_True;
+        return;
+    }
+    memcpy(encoder->output + encoder->output_used, data, size);
+    encoder->output_used += size;
+}
+
+// NOTE: NULL (and error set) once the arena is used up
+static JSONBinaryEntry* gjson_binary_push_entry(JSONBinaryEncoder* encoder)
+{
+    if (encoder->entry_count == encoder->entry_capacity)
+    {
+        encoder->error = gj_True;
+        return NULL;
+    }
+    if (encoder->entry_count == encoder->entry_peak) encoder->entry_peak++;
+    return &encoder->entries[encoder->entry_count++];
+}
+
+static inline void gjson_binary_put_tag(JSONBinaryEncoder* encoder, GJSON_BinaryType type)
+{
+    u8 tag = (u8)type;
+    gjson_binary_put(encoder, &tag, sizeof(tag));
+}
+
+static void gjson_binary_skip_whitespace(JSONBinaryEncoder* encoder)
+{
+    while (encoder->cursor < encoder->size && gj_IsWhitespace(encoder->data[encoder->cursor])) encoder->cursor++;
+}
+
+// NOTE: Cursor on the opening quote, leaves it past the closing one
+static void gjson_binary_scan_string(JSONBinaryEncoder* encoder, const char** string, u32* length)
+{
+    size_t start  = ++encoder->cursor;
+    size_t cursor = start;
+    while (gj_True)
+    {
+        // NOTE: A trailing backslash steps past the end
+        if (cursor < encoder->size) cursor += gjson_find_string_special(encoder->data + cursor, encoder->size - cursor);
+        if (cursor >= encoder->size)
+        {
+            encoder->error = gj_True;
+            return;
+        }
+        char c = encoder->data[cursor++];
+        if      (c == GJSON_STRING) break;
+        else if (c == '\\')         cursor++;
+    }
+    encoder->cursor = cursor;
+
+    size_t string_length = cursor - 1 - start;
+    if (string_length > 0xFFFFFFFF) encoder->error = gj_True;
+    *string = encoder->data + start;
+    *length = (u32)string_length;
+}
+
+static u64 gjson_binary_put_string(JSONBinaryEncoder* encoder, const char* string, u32 length)
+{
+    u64 result = encoder->output_used;
+    gjson_binary_put_tag(encoder, GJSON_BinaryType_String);
+    gjson_binary_put(encoder, &length, sizeof(length));
+    gjson_binary_put(encoder, string, length);
+    return result;
+}
+
+static u64 gjson_binary_encode_key(JSONBinaryEncoder* encoder, const char** key, u32* key_length)
+{
+    gjson_binary_scan_string(encoder, key, key_length);
+    if (encoder->error) return 0;
+
+    // NOTE: FNV-1a
+    u32 hash = 2166136261u;
+    for (u32 i = 0; i < *key_length; i++) hash = (hash ^ (u8)(*key)[i]) * 16777619u;
+
+    JSONBinaryKey* slot = NULL;
+    for (u32 i = 0; i < JSON_BINARY_KEY_TABLE_SIZE; i++)
+    {
+        slot = &encoder->key_table[(hash + i) & (JSON_BINARY_KEY_TABLE_SIZE - 1)];
+        if (!slot->key) break;
+        if (slot->key_length == *key_length && memcmp(slot->key, *key, *key_length) == 0) return slot->key_offset;
+    }
+
+    u64 result = gjson_binary_put_string(encoder, *key, *key_length);
+    // NOTE: Kept a quarter empty so probes stay short, later new keys aren't shared
+    if (encoder->key_table_count < JSON_BINARY_KEY_TABLE_SIZE * 3 / 4)
+    {
+        slot->key        = *key;
+        slot->key_length = *key_length;
+        slot->key_offset = result;
+        encoder->key_table_count++;
+    }
+    return result;
+}
+
+static u64 gjson_binary_encode_number(JSONBinaryEncoder* encoder)
+{
+    size_t start      = encoder->cursor;
+    int    is_integer = gj_True;
+    while (encoder->cursor < encoder->size)
+    {
+        char c = encoder->data[encoder->cursor];
+        if (c == GJSON_FRACTION || c == GJSON_EXPONENT_E || c == GJSON_EXPONENT_e) is_integer = gj_False;
+        else if (!gj_IsDigit(c) && c != GJSON_SIGN_NEGATIVE && c != GJSON_SIGN_POSITIVE) break;
+        encoder->cursor++;
+    }
+
+    char   number[64];
+    size_t number_size = encoder->cursor - start;
+    if (number_size == 0 || number_size >= sizeof(number))
+    {
+        encoder->error = gj_True;
+        return 0;
+    }
+    memcpy(number, encoder->data + start, number_size);
+    number[number_size] = 0;
+
+    // NOTE: 18 digits always fit an s64
+    size_t digits = number_size - (number[0] == GJSON_SIGN_NEGATIVE);
+    if (digits > 18) is_integer = gj_False;
+
+    u64 result = encoder->output_used;
+    char* end;
+    if (is_integer)
+    {
+        s64 value = (s64)strtoll(number, &end, 10);
+        gjson_binary_put_tag(encoder, GJSON_BinaryType_Integer);
+        gjson_binary_put(encoder, &value, sizeof(value));
+    }
+    else
+    {
+        f64 value = strtod(number, &end);
+        gjson_binary_put_tag(encoder, GJSON_BinaryType_Double);
+        gjson_binary_put(encoder, &value, sizeof(value));
+    }
+    if (end != number + number_size) encoder->error = gj_True;
+    return result;
+}
+
+static u64 gjson_binary_encode_value(JSONBinaryEncoder* encoder);
+
+static u64 gjson_binary_encode_array(JSONBinaryEncoder* encoder)
+{
+    // NOTE: Element offsets share the entry stack, only value_offset is used
+    size_t base = encoder->entry_count;
+    encoder->cursor++;
+    gjson_binary_skip_whitespace(encoder);
+    if (encoder->cursor < encoder->size && encoder->data[encoder->cursor] == GJSON_ARRAY_END)
+    {
+        encoder->cursor++;
+    }
+    else
+    {
+        while (!encoder->error)
+        {
+            u64 value_offset = gjson_binary_encode_value(encoder);
+            if (encoder->error) break;
+            JSONBinaryEntry* entry = gjson_binary_push_entry(encoder);
+            if (!entry) break;
+            entry->value_offset = value_offset;
+
+            gjson_binary_skip_whitespace(encoder);
+            char c = encoder->cursor < encoder->size ? encoder->data[encoder->cursor] : 0;
+            encoder->cursor++;
+            if (c == GJSON_ARRAY_END) break;
+            if (c != GJSON_ELEMENT_SEPARATOR) encoder->error = gj_True;
+        }
+    }
+
+    u64 result = encoder->output_used;
+    u32 count  = (u32)(encoder->entry_count - base);
+    gjson_binary_put_tag(encoder, GJSON_BinaryType_Array);
+    gjson_binary_put(encoder, &count, sizeof(count));
+    for (size_t i = base; i < encoder->entry_count; i++)
+    {
+        gjson_binary_put(encoder, &encoder->entries[i].value_offset, sizeof(u64));
+    }
+    encoder->entry_count = base;
+    return result;
+}
+
+static u64 gjson_binary_encode_object(JSONBinaryEncoder* encoder)
+{
+    size_t base = encoder->entry_count;
+    encoder->cursor++;
+    gjson_binary_skip_whitespace(encoder);
+    if (encoder->cursor < encoder->size && encoder->data[encoder->cursor] == GJSON_OBJECT_END)
+    {
+        encoder->cursor++;
+    }
+    else
+    {
+        while (!encoder->error)
+        {
+            JSONBinaryEntry entry;
+            gjson_binary_skip_whitespace(encoder);
+            if (encoder->cursor >= encoder->size || encoder->data[encoder->cursor] != GJSON_STRING)
+            {
+                encoder->error = gj_True;
+                break;
+            }
+            entry.key_offset = gjson_binary_encode_key(encoder, &entry.key, &entry.key_length);
+            if (encoder->error) break;
+
+            gjson_binary_skip_whitespace(encoder);
+            if (encoder->cursor >= encoder->size || encoder->data[encoder->cursor] != GJSON_MEMBER_COLON)
+            {
+                encoder->error = gj_True;
+                break;
+            }
+            encoder->cursor++;
+
+            entry.value_offset = gjson_binary_encode_value(encoder);
+            if (encoder->error) break;
+            JSONBinaryEntry* pushed = gjson_binary_push_entry(encoder);
+            if (!pushed) break;
+            *pushed = entry;
+
+            gjson_binary_skip_whitespace(encoder);
+            char c = encoder->cursor < encoder->size ? encoder->data[encoder->cursor] : 0;
+            encoder->cursor++;
+            if (c == GJSON_OBJECT_END) break;
+            if (c != GJSON_ELEMENT_SEPARATOR) encoder->error = gj_True;
+        }
+    }
+
+    u32 count = (u32)(encoder->entry_count - base);
+    qsort(encoder->entries + base, count, sizeof(JSONBinaryEntry), gjson_binary_entry_compare);
+
+    u64 result = encoder->output_used;
+    gjson_binary_put_tag(encoder, GJSON_BinaryType_Object);
+    gjson_binary_put(encoder, &count, sizeof(count));
+    for (size_t i = base; i < encoder->entry_count; i++)
+    {
+        gjson_binary_put(encoder, &encoder->entries[i].key_offset,   sizeof(u64));
+        gjson_binary_put(encoder, &encoder->entries[i].value_offset, sizeof(u64));
+    }
+    encoder->entry_count = base;
+    return result;
+}
+
+static u64 gjson_binary_encode_value(JSONBinaryEncoder* encoder)
+{
+    gjson_binary_skip_whitespace(encoder);
+    if (encoder->cursor >= encoder->size || encoder->depth == JSON_PARSE_QUEUE_SIZE)
+    {
+        encoder->error = gj_True;
+        return 0;
+    }
+
+    const char* data      = encoder->data + encoder->cursor;
+    size_t      remaining = encoder->size - encoder->cursor;
+    u64         result    = encoder->output_used;
+    switch (data[0])
+    {
+        case GJSON_OBJECT_START:
+        case GJSON_ARRAY_START:
+        {
+            encoder->depth++;
+            result = data[0] == GJSON_OBJECT_START ? gjson_binary_encode_object(encoder) : gjson_binary_encode_array(encoder);
+            encoder->depth--;
+        } break;
+
+        case GJSON_STRING:
+        {
+            const char* string;
+            u32         length;
+            gjson_binary_scan_string(encoder, &string, &length);
+            if (!encoder->error) result = gjson_binary_put_string(encoder, string, length);
+        } break;
+
+        case 't':
+        case 'f':
+        case 'n':
+        {
+            GJSON_BinaryType type;
+            size_t           length;
+            if      (remaining >= 4 && memcmp(data, GJSON_TRUE,  4) == 0) { type = GJSON_BinaryType_True;  length = 4; }
+            else if (remaining >= 5 && memcmp(data, GJSON_FALSE, 5) == 0) { type = GJSON_BinaryType_False; length = 5; }
+            else if (remaining >= 4 && memcmp(data, GJSON_NULL,  4) == 0) { type = GJSON_BinaryType_Null;  length = 4; }
+            else
+            {
+                encoder->error = gj_True;
+                break;
+            }
+            encoder->cursor += length;
+            gjson_binary_put_tag(encoder, type);
+        } break;
+
+        default:
+        {
+            if (data[0] != GJSON_SIGN_NEGATIVE && !gj_IsDigit(data[0]))
+            {
+                encoder->error = gj_True;
+                break;
+            }
+            result = gjson_binary_encode_number(encoder);
+        } break;
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reader
+//////////////////////////////////////////////////////////////////////
+// NOTE: Offsets come from the (possibly corrupt) data, anything reaching
+//       past binary->size reads as 0
+static inline int gjson_binary_in_bounds(GJSON_Binary* binary, u64 offset, u64 size)
+{
+    return offset <= binary->size && size <= binary->size - offset;
+}
+
+static inline u32 gjson_binary_read_u32(GJSON_Binary* binary, u64 offset)
+{
+    u32 result = 0;
+    if (gjson_binary_in_bounds(binary, offset, sizeof(result))) memcpy(&result, binary->data + offset, sizeof(result));
+    return result;
+}
+
+static inline u64 gjson_binary_read_u64(GJSON_Binary* binary, u64 offset)
+{
+    u64 result = 0;
+    if (gjson_binary_in_bounds(binary, offset, sizeof(result))) memcpy(&result, binary->data + offset, sizeof(result));
+    return result;
+}
+
+// NOTE: Offsets of the count and the first table entry of a container
+#define GJSON_BINARY_COUNT_OFFSET(Value) ((Value) + 1)
+#define GJSON_BINARY_TABLE_OFFSET(Value) ((Value) + 1 + sizeof(u32))
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static size_t gjson_binary_encode(GJSON_State* gjson, const void* json, size_t json_size,
+                                  void* output, size_t output_size)
+{
+    JSONBinaryEncoder encoder;
+    gj_ZeroMemory(&encoder);
+    encoder.data        = (const char*)json;
+    encoder.size        = json_size;
+    encoder.output      = (u8*)output;
+    encoder.output_size = output_size;
+
+    GJSON_Checkpoint checkpoint      = gjson_checkpoint(gjson);
+    size_t           high_water_mark = gjson_memory_high_water_mark(gjson);
+    MemoryArena* arena = &gjson->memory_arena;
+    // NOTE: Slack for arena alignment
+    gj_Assert(arena->size - arena->used >= JSON_BINARY_KEY_TABLE_SIZE * sizeof(JSONBinaryKey) + 64);
+    encoder.key_table = PushArray(arena, JSON_BINARY_KEY_TABLE_SIZE, JSONBinaryKey);
+    memset(encoder.key_table, 0, JSON_BINARY_KEY_TABLE_SIZE * sizeof(JSONBinaryKey));
+    size_t free_size     = arena->size - arena->used;
+    size_t entries_start = arena->used;
+    encoder.entry_capacity = free_size > 64 ? (free_size - 64) / sizeof(JSONBinaryEntry) : 0;
+    encoder.entries        = PushArray(arena, encoder.entry_capacity, JSONBinaryEntry);
+
+    u8 header[GJSON_BINARY_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    gjson_binary_put(&encoder, header, sizeof(header));
+
+    u64 root = gjson_binary_encode_value(&encoder);
+    gjson_binary_skip_whitespace(&encoder);
+    if (encoder.cursor != encoder.size) encoder.error = gj_True;
+    gjson_rollback(gjson, checkpoint);
+    // NOTE: Rollback counted the whole entries reservation, only entry_peak was used
+    gjson->memory_high_water_mark = gj_Max(high_water_mark, entries_start + encoder.entry_peak * sizeof(JSONBinaryEntry));
+    if (encoder.error) return 0;
+
+    u32 magic   = GJSON_BINARY_MAGIC;
+    u32 version = GJSON_BINARY_VERSION;
+    u64 size    = encoder.output_used;
+    memcpy(encoder.output,                                 &magic,   sizeof(magic));
+    memcpy(encoder.output + sizeof(u32),                   &version, sizeof(version));
+    memcpy(encoder.output + 2 * sizeof(u32),               &root,    sizeof(root));
+    memcpy(encoder.output + 2 * sizeof(u32) + sizeof(u64), &size,    sizeof(size));
+    return encoder.output_used;
+}
+
+static int gjson_binary_open(GJSON_Binary* binary, const void* data, size_t size)
+{
+    gj_ZeroMemory(binary);
+    binary->data = (const u8*)data;
+    binary->size = size;
+    if (size < GJSON_BINARY_HEADER_SIZE) return gj_False;
+    if (gjson_binary_read_u32(binary, 0)           != GJSON_BINARY_MAGIC)   return gj_False;
+    if (gjson_binary_read_u32(binary, sizeof(u32)) != GJSON_BINARY_VERSION) return gj_False;
+    if (gjson_binary_read_u64(binary, 2 * sizeof(u32) + sizeof(u64)) > size) return gj_False;
+    binary->root = gjson_binary_read_u64(binary, 2 * sizeof(u32));
+    return binary->root >= GJSON_BINARY_HEADER_SIZE && binary->root < size;
+}
+
+static GJSON_BinaryType gjson_binary_type(GJSON_Binary* binary, GJSON_BinaryValue value)
+{
+    if (value == 0 || value >= binary->size) return GJSON_BinaryType_None;
+    u8 tag = binary->data[value];
+    if (tag > GJSON_BinaryType_Object) return GJSON_BinaryType_None;
+    return (GJSON_BinaryType)tag;
+}
+
+static u32 gjson_binary_count(GJSON_Binary* binary, GJSON_BinaryValue value)
+{
+    GJSON_BinaryType type = gjson_binary_type(binary, value);
+    if (type != GJSON_BinaryType_Array && type != GJSON_BinaryType_Object) return 0;
+    u32 count      = gjson_binary_read_u32(binary, GJSON_BINARY_COUNT_OFFSET(value));
+    u64 entry_size = type == GJSON_BinaryType_Object ? 2 * sizeof(u64) : sizeof(u64);
+    // NOTE: A table running past the end is corrupt, treated as empty
+    if (!gjson_binary_in_bounds(binary, GJSON_BINARY_TABLE_OFFSET(value), (u64)count * entry_size)) return 0;
+    return count;
+}
+
+static GJSON_BinaryValue gjson_binary_element(GJSON_Binary* binary, GJSON_BinaryValue array, u32 index)
+{
+    if (gjson_binary_type(binary, array) != GJSON_BinaryType_Array || index >= gjson_binary_count(binary, array)) return 0;
+    return gjson_binary_read_u64(binary, GJSON_BINARY_TABLE_OFFSET(array) + (u64)index * sizeof(u64));
+}
+
+static GJSON_BinaryValue gjson_binary_member(GJSON_Binary* binary, GJSON_BinaryValue object, u32 index, GJSON_BinaryValue* key)
+{
+    if (key) *key = 0;
+    if (gjson_binary_type(binary, object) != GJSON_BinaryType_Object || index >= gjson_binary_count(binary, object)) return 0;
+    u64 entry = GJSON_BINARY_TABLE_OFFSET(object) + (u64)index * 2 * sizeof(u64);
+    if (key) *key = gjson_binary_read_u64(binary, entry);
+    return gjson_binary_read_u64(binary, entry + sizeof(u64));
+}
+
+static GJSON_BinaryValue gjson_binary_get(GJSON_Binary* binary, GJSON_BinaryValue object, const char* key, int key_length)
+{
+    if (gjson_binary_type(binary, object) != GJSON_BinaryType_Object) return 0;
+
+    u32 low  = 0;
+    u32 high = gjson_binary_count(binary, object);
+    while (low < high)
+    {
+        u32 middle = low + (high - low) / 2;
+        GJSON_BinaryValue member_key;
+        GJSON_BinaryValue member_value = gjson_binary_member(binary, object, middle, &member_key);
+
+        u32         member_key_length;
+        const char* member_key_string = gjson_binary_string(binary, member_key, &member_key_length);
+        if (!member_key_string) return 0;
+        int compare = gjson_binary_key_compare(member_key_string, member_key_length, key, (u32)key_length);
+        if      (compare < 0) low  = middle + 1;
+        else if (compare > 0) high = middle;
+        else return member_value;
+    }
+    return 0;
+}
+
+static s64 gjson_binary_integer(GJSON_Binary* binary, GJSON_BinaryValue value)
+{
+    if (gjson_binary_type(binary, value) != GJSON_BinaryType_Integer) return 0;
+    return (s64)gjson_binary_read_u64(binary, value + 1);
+}
+
+static f64 gjson_binary_double(GJSON_Binary* binary, GJSON_BinaryValue value)
+{
+    GJSON_BinaryType type = gjson_binary_type(binary, value);
+    if (type == GJSON_BinaryType_Integer) return (f64)gjson_binary_integer(binary, value);
+    if (type != GJSON_BinaryType_Double)  return 0;
+    u64 bits = gjson_binary_read_u64(binary, value + 1);
+    f64 result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static const char* gjson_binary_string(GJSON_Binary* binary, GJSON_BinaryValue value, u32* length)
+{
+    *length = 0;
+    if (gjson_binary_type(binary, value) != GJSON_BinaryType_String) return NULL;
+    u32 string_length = gjson_binary_read_u32(binary, value + 1);
+    if (!gjson_binary_in_bounds(binary, value + 1 + sizeof(u32), string_length)) return NULL;
+    *length = string_length;
+    return (const char*)binary->data + value + 1 + sizeof(u32);
+}
+
+static int gjson_binary_search(GJSON_Binary* binary, GJSON_BinarySearch* search, GJSON_Query query,
+                               GJSON_BinaryValue* value, int* key_index)
+{
+    GJSON_QueryKey  single_key;
+    GJSON_QueryKey* keys      = query.keys;
+    int             key_count = query.key_count;
+    if (query.type == GJSON_QueryType_ObjectKey)
+    {
+        single_key.string_length = query.string_length;
+        single_key.string        = query.string;
+        keys      = &single_key;
+        key_count = 1;
+    }
+
+    if (search->done) return gj_False;
+    if (search->depth == 0)
+    {
+        GJSON_BinaryType root_type = gjson_binary_type(binary, binary->root);
+        if (root_type != GJSON_BinaryType_Array && root_type != GJSON_BinaryType_Object)
+        {
+            search->done = gj_True;
+            return gj_False;
+        }
+        gj_ZeroMemory(&search->stack[0]);
+        search->stack[0].container = binary->root;
+        search->depth = 1;
+    }
+
+    while (search->depth > 0)
+    {
+        GJSON_BinarySearchFrame* frame = &search->stack[search->depth - 1];
+        int is_object = gjson_binary_type(binary, frame->container) == GJSON_BinaryType_Object;
+
+        while (is_object && frame->key_index < key_count)
+        {
+            GJSON_QueryKey* key = &keys[frame->key_index++];
+            GJSON_BinaryValue hit = gjson_binary_get(binary, frame->container, key->string, key->string_length);
+            if (hit)
+            {
+                *value     = hit;
+                *key_index = frame->key_index - 1;
+                return gj_True;
+            }
+        }
+
+        if (frame->index < gjson_binary_count(binary, frame->container))
+        {
+            u32 index = frame->index++;
+            GJSON_BinaryValue child = is_object ? gjson_binary_member(binary, frame->container, index, NULL)
+                                                : gjson_binary_element(binary, frame->container, index);
+            GJSON_BinaryType child_type = gjson_binary_type(binary, child);
+            // NOTE: Children are written first, a child at or after its parent
+            //       is corrupt and could loop forever
+            if ((child_type == GJSON_BinaryType_Array || child_type == GJSON_BinaryType_Object) &&
+                child < frame->container && search->depth < JSON_PARSE_QUEUE_SIZE)
+            {
+                GJSON_BinarySearchFrame* child_frame = &search->stack[search->depth++];
+                gj_ZeroMemory(child_frame);
+                child_frame->container = child;
+            }
+            continue;
+        }
+
+        search->depth--;
+    }
+
+    search->done = gj_True;
+    return gj_False;
+}
+
+#endif
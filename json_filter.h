@@ -0,0 +1,128 @@
+#if !defined(JSON_FILTER_H)
+#define JSON_FILTER_H
+
+#include "json.h"
+#include "json_write.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef enum GJSON_FilterAction
+{
+    // NOTE: Drops the whole member including one adjacent separator
+    GJSON_FilterAction_Remove,
+    // NOTE: Replaces the member's value with replacement (raw JSON)
+    GJSON_FilterAction_Replace
+} GJSON_FilterAction;
+
+typedef struct GJSON_Filter
+{
+    GJSON_Query        query;
+    GJSON_FilterAction action;
+    const char*        replacement;
+    size_t             replacement_size;
+} GJSON_Filter;
+
+typedef struct GJSON_FilterResult
+{
+    size_t hits;
+    size_t read_bytes;
+    // NOTE: Malformed or cut off input at read_bytes, writer only got the
+    //       output up to the last member filtered before it
+    int    error;
+} GJSON_FilterResult;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: gjson->data must hold complete top-level values (a whole document,
+//       NDJSON lines or an mmap). Everything not matched by filter.query is
+//       copied through to writer verbatim without being decoded. Nothing past
+//       an error is copied, so unfiltered input never reaches writer.
+static GJSON_FilterResult gjson_filter(GJSON_State* gjson, GJSON_Filter filter, GJSON_Writer* writer);
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_FilterResult gjson_filter(GJSON_State* gjson, GJSON_Filter filter, GJSON_Writer* writer)
+{
+    GJSON_FilterResult result;
+    gj_ZeroMemory(&result);
+
+    char*  data   = (char*)gjson->data;
+    size_t size   = gjson->size;
+    size_t offset = 0;
+    size_t copied = 0;
+
+    while (offset < size)
+    {
+        gjson->data = data + offset;
+        gjson->size = size - offset;
+        GJSON_QueryResult query_result = gjson_search(gjson, filter.query);
+        if (query_result.type != GJSON_QueryResultType_Hit)
+        {
+            offset += query_result.read_bytes;
+            break;
+        }
+
+        size_t key_start = offset + query_result.match_start;
+        offset += query_result.read_bytes;
+
+        gjson->data = data + offset;
+        gjson->size = size - offset;
+        GJSON_Span value;
+        if (gjson_skip_member_value(gjson, &value) != GJSON_QueryResultType_Hit) break;
+        size_t value_start = offset + value.start;
+        size_t value_end   = offset + value.end;
+
+        if (filter.action == GJSON_FilterAction_Replace)
+        {
+            gjson_writer_put(writer, data + copied, value_start - copied);
+            gjson_writer_put(writer, filter.replacement, filter.replacement_size);
+            copied = value_end;
+        }
+        else
+        {
+            gj_Assert(filter.action == GJSON_FilterAction_Remove);
+            size_t cut_start = key_start;
+            size_t cut_end   = value_end;
+
+            size_t before = key_start;
+            while (before > copied && gj_IsWhitespace(data[before - 1])) before--;
+            if (before > copied && data[before - 1] == GJSON_ELEMENT_SEPARATOR)
+            {
+                cut_start = before - 1;
+            }
+            else
+            {
+                // NOTE: First member, take the following separator instead
+                size_t after = value_end;
+                while (after < size && gj_IsWhitespace(data[after])) after++;
+                if (after < size && data[after] == GJSON_ELEMENT_SEPARATOR)
+                {
+                    after++;
+                    while (after < size && gj_IsWhitespace(data[after])) after++;
+                    cut_end = after;
+                }
+            }
+
+            gjson_writer_put(writer, data + copied, cut_start - copied);
+            copied = cut_end;
+        }
+
+        offset = value_end;
+        result.hits++;
+    }
+
+    // NOTE: Malformed input and input cut off inside a value both leave the
+    //       parse stack incomplete
+    result.error = !gjson_parse_queue_complete(gjson->parse_queue);
+    if (!result.error) gjson_writer_put(writer, data + copied, size - copied);
+
+    gjson->data = data;
+    gjson->size = size;
+    result.read_bytes = offset;
+    return result;
+}
+
+#endif
@@ -0,0 +1,317 @@
+#if !defined(JSON_FOLLOW_H)
+#define JSON_FOLLOW_H
+
+#include "json.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// NOTE: Define GJSON_INOTIFY to 0 to always poll
+#if !defined(GJSON_INOTIFY)
+#if defined(__linux__)
+#define GJSON_INOTIFY 1
+#else
+#define GJSON_INOTIFY 0
+#endif
+#endif
+
+#if GJSON_INOTIFY
+#include <sys/inotify.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef struct GJSON_Follow
+{
+    const char* path;
+#if defined(_WIN32)
+    HANDLE file;
+#else
+    int    file;
+    int    inotify;
+    int    watch;
+#endif
+    int    poll_interval_ms;
+
+    char*  buffer;
+    size_t buffer_size;
+    size_t buffer_used;
+    size_t buffer_read;
+    // NOTE: File offset of buffer[0]
+    u64    buffer_offset;
+    // NOTE: Times the file was truncated or replaced, offsets restart at 0
+    int    restarts;
+    // NOTE: Malformed records skipped, the parse resumes at the next line
+    int    errors;
+    // NOTE: Still skipping to the next newline after an error
+    int    skip_line;
+    // NOTE: buffer_read after the last Hit or resync, a resync never goes back past it
+    size_t resync_floor;
+} GJSON_Follow;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: Starts reading path from its beginning, NULL if it can't be opened.
+//       Waits on inotify where available and re-checks every poll_interval_ms.
+static GJSON_Follow* gjson_follow_open(GJSON_State* gjson, const char* path, size_t buffer_size, int poll_interval_ms);
+// NOTE: Runs gjson_search over bytes as they are appended. Returns gj_True on
+//       a Hit with result->read_bytes as the file offset just past the key
+//       (match_start is not translated), gj_False once timeout_ms passes
+//       without one (-1 waits forever). The parse state is kept across calls.
+//       Malformed JSON is counted and skipped, NDJSON style: the parse
+//       restarts at the start of the broken line's successor, or of the line
+//       the error is on when that's still in the buffer. A truncated or
+//       replaced file starts over, but truncation is only seen if the file is
+//       still shorter than the read offset at the next poll, one that regrows
+//       past it in between is read on from the old offset (and resyncs).
+static int  gjson_follow_search(GJSON_Follow* follow, GJSON_State* gjson, GJSON_Query query,
+                                GJSON_QueryResult* result, int timeout_ms);
+// NOTE: Malformed records skipped so far
+static int  gjson_follow_error(GJSON_Follow* follow);
+static void gjson_follow_close(GJSON_Follow* follow);
+
+//////////////////////////////////////////////////////////////////////
+// Platform
+//////////////////////////////////////////////////////////////////////
+#if defined(_WIN32)
+static u64 gjson_follow_time_ms() { return GetTickCount64(); }
+
+static int gjson_follow_open_file(GJSON_Follow* follow)
+{
+    follow->file = CreateFileA(follow->path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    return follow->file != INVALID_HANDLE_VALUE;
+}
+
+static void gjson_follow_close_file(GJSON_Follow* follow)
+{
+    if (follow->file != INVALID_HANDLE_VALUE) CloseHandle(follow->file);
+    follow->file = INVALID_HANDLE_VALUE;
+}
+
+static size_t gjson_follow_read(GJSON_Follow* follow, char* buffer, size_t size)
+{
+    DWORD read_bytes = 0;
+    if (!ReadFile(follow->file, buffer, (DWORD)gj_Min(size, (size_t)0x7FFFFFFF), &read_bytes, 0)) return 0;
+    return read_bytes;
+}
+
+// NOTE: Truncation only, renames aren't detected without a directory watch
+static int gjson_follow_replaced(GJSON_Follow* follow, u64 file_offset)
+{
+    LARGE_INTEGER size;
+    if (follow->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(follow->file, &size)) return gj_True;
+    return (u64)size.QuadPart < file_offset;
+}
+
+static void gjson_follow_wait(GJSON_Follow* follow, int wait_ms) { Sleep((DWORD)wait_ms); }
+#else
+static u64 gjson_follow_time_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000 + (u64)now.tv_nsec / 1000000;
+}
+
+static int gjson_follow_open_file(GJSON_Follow* follow)
+{
+    follow->file = open(follow->path, O_RDONLY);
+    if (follow->file < 0) return gj_False;
+#if GJSON_INOTIFY
+    if (follow->inotify >= 0)
+    {
+        follow->watch = inotify_add_watch(follow->inotify, follow->path,
+                                          IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    }
+#endif
+    return gj_True;
+}
+
+static void gjson_follow_close_file(GJSON_Follow* follow)
+{
+#if GJSON_INOTIFY
+    if (follow->inotify >= 0 && follow->watch >= 0) inotify_rm_watch(follow->inotify, follow->watch);
+    follow->watch = -1;
+#endif
+    if (follow->file >= 0) close(follow->file);
+    follow->file = -1;
+}
+
+static size_t gjson_follow_read(GJSON_Follow* follow, char* buffer, size_t size)
+{
+    ssize_t read_bytes = read(follow->file, buffer, size);
+    return read_bytes > 0 ? (size_t)read_bytes : 0;
+}
+
+// NOTE: Truncated, or path now names another file (log rotation)
+static int gjson_follow_replaced(GJSON_Follow* follow, u64 file_offset)
+{
+    struct stat file_stat;
+    struct stat path_stat;
+    if (fstat(follow->file, &file_stat) != 0) return gj_True;
+    if ((u64)file_stat.st_size < file_offset) return gj_True;
+    if (stat(follow->path, &path_stat) != 0) return gj_False;
+    return path_stat.st_ino != file_stat.st_ino || path_stat.st_dev != file_stat.st_dev;
+}
+
+static void gjson_follow_wait(GJSON_Follow* follow, int wait_ms)
+{
+#if GJSON_INOTIFY
+    if (follow->inotify >= 0 && follow->watch >= 0)
+    {
+        struct pollfd poll_fd;
+        poll_fd.fd      = follow->inotify;
+        poll_fd.events  = POLLIN;
+        poll_fd.revents = 0;
+        if (poll(&poll_fd, 1, wait_ms) > 0)
+        {
+            // NOTE: Events only wake us, drain them
+            char events[4096];
+            while (read(follow->inotify, events, sizeof(events)) > 0) {}
+        }
+        return;
+    }
+#endif
+    usleep((useconds_t)wait_ms * 1000);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_Follow* gjson_follow_open(GJSON_State* gjson, const char* path, size_t buffer_size, int poll_interval_ms)
+{
+    gj_Assert(buffer_size > 0 && poll_interval_ms > 0);
+    GJSON_Follow* follow = PushStruct(&gjson->memory_arena, GJSON_Follow);
+    gj_ZeroMemory(follow);
+    follow->path             = path;
+    follow->poll_interval_ms = poll_interval_ms;
+    follow->buffer_size      = buffer_size;
+    follow->buffer           = (char*)PushSize(&gjson->memory_arena, buffer_size);
+#if !defined(_WIN32)
+    follow->watch   = -1;
+    follow->inotify = -1;
+#if GJSON_INOTIFY
+    follow->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+#endif
+
+    if (!gjson_follow_open_file(follow))
+    {
+        gjson_follow_close(follow);
+        return NULL;
+    }
+    return follow;
+}
+
+// NOTE: Restarts the parse after the last newline before error_at if the
+//       buffer still holds one past resync_floor, else after the next one
+static void gjson_follow_resync(GJSON_Follow* follow, GJSON_State* gjson, size_t error_at)
+{
+    gjson_parse_queue_clear(gjson->parse_queue);
+    follow->errors++;
+
+    for (size_t cursor = error_at; cursor > follow->resync_floor; cursor--)
+    {
+        if (follow->buffer[cursor - 1] == '\n')
+        {
+            follow->buffer_read  = cursor;
+            follow->resync_floor = cursor;
+            return;
+        }
+    }
+    follow->buffer_read = error_at;
+    follow->skip_line   = gj_True;
+}
+
+static int gjson_follow_search(GJSON_Follow* follow, GJSON_State* gjson, GJSON_Query query,
+                               GJSON_QueryResult* result, int timeout_ms)
+{
+    u64 start_ms = gjson_follow_time_ms();
+    while (gj_True)
+    {
+        if (follow->skip_line && follow->buffer_read < follow->buffer_used)
+        {
+            char* line_end = (char*)memchr(follow->buffer + follow->buffer_read, '\n',
+                                           follow->buffer_used - follow->buffer_read);
+            follow->buffer_read = line_end ? (size_t)(line_end - follow->buffer) + 1 : follow->buffer_used;
+            if (!line_end) continue;
+            follow->skip_line    = gj_False;
+            follow->resync_floor = follow->buffer_read;
+        }
+
+        if (follow->buffer_read < follow->buffer_used)
+        {
+            gjson->data = follow->buffer + follow->buffer_read;
+            gjson->size = follow->buffer_used - follow->buffer_read;
+            GJSON_QueryResult query_result = gjson_search(gjson, query);
+            follow->buffer_read += query_result.read_bytes;
+
+            if (query_result.type == GJSON_QueryResultType_Hit)
+            {
+                follow->resync_floor = follow->buffer_read;
+                *result = query_result;
+                result->read_bytes  = follow->buffer_offset + follow->buffer_read;
+                result->match_start = 0;
+                return gj_True;
+            }
+            if (query_result.type == GJSON_QueryResultType_Error)
+            {
+                gjson_follow_resync(follow, gjson, follow->buffer_read);
+            }
+            continue;
+        }
+
+        // NOTE: The parser keeps its own state, consumed bytes aren't needed
+        follow->buffer_offset += follow->buffer_used;
+        follow->buffer_used    = gjson_follow_read(follow, follow->buffer, follow->buffer_size);
+        follow->buffer_read    = 0;
+        follow->resync_floor   = 0;
+        if (follow->buffer_used > 0) continue;
+
+        if (gjson_follow_replaced(follow, follow->buffer_offset))
+        {
+            gjson_follow_close_file(follow);
+            if (gjson_follow_open_file(follow))
+            {
+                gjson_parse_queue_clear(gjson->parse_queue);
+                follow->skip_line     = gj_False;
+                follow->buffer_offset = 0;
+                follow->restarts++;
+                continue;
+            }
+        }
+
+        u64 elapsed_ms = gjson_follow_time_ms() - start_ms;
+        if (timeout_ms >= 0 && elapsed_ms >= (u64)timeout_ms) break;
+        int wait_ms = follow->poll_interval_ms;
+        if (timeout_ms >= 0) wait_ms = (int)gj_Min((u64)wait_ms, (u64)timeout_ms - elapsed_ms);
+        gjson_follow_wait(follow, wait_ms);
+    }
+    return gj_False;
+}
+
+static int gjson_follow_error(GJSON_Follow* follow)
+{
+    return follow->errors;
+}
+
+static void gjson_follow_close(GJSON_Follow* follow)
+{
+    gjson_follow_close_file(follow);
+#if GJSON_INOTIFY
+    if (follow->inotify >= 0) close(follow->inotify);
+    follow->inotify = -1;
+#endif
+}
+
+#endif
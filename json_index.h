@@ -0,0 +1,318 @@
+#if !defined(JSON_INDEX_H)
+#define JSON_INDEX_H
+
+#include "json.h"
+#include "json_write.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef enum GJSON_IndexLayout
+{
+    // NOTE: Records are top-level values, NDJSON or concatenated JSON
+    GJSON_IndexLayout_Values,
+    // NOTE: Records are the elements of one top-level array
+    GJSON_IndexLayout_ArrayElements
+} GJSON_IndexLayout;
+
+// NOTE: Parse stack at offset inside a record that crosses a snapshot
+//       boundary. Never inside a key, so any query can resume from it.
+typedef struct GJSON_IndexSnapshot
+{
+    u64 offset;
+    u64 record;
+    u8  state;
+    u8  depth;
+    u8  stack[JSON_PARSE_QUEUE_SIZE];
+    u8  pad[2];
+} GJSON_IndexSnapshot;
+
+typedef struct GJSON_Index
+{
+    GJSON_IndexLayout    layout;
+    u64                  data_size;
+    u64                  snapshot_interval;
+    u64                  record_count;
+    u64*                 record_offsets;
+    u64                  snapshot_count;
+    GJSON_IndexSnapshot* snapshots;
+} GJSON_Index;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: One pass over complete data (e.g. an mmap). Record offsets take the
+//       rest of gjson->memory_arena and are trimmed to what was used, push
+//       nothing else before the index is written. snapshot_interval 0 takes
+//       no snapshots. gj_False on malformed input or out of memory.
+static int  gjson_index_build(GJSON_State* gjson, GJSON_Index* index, const void* data, size_t size,
+                              GJSON_IndexLayout layout, size_t snapshot_interval);
+// NOTE: Sidecar file contents
+static void gjson_index_write(GJSON_Index* index, GJSON_Writer* writer);
+// NOTE: Points index into a sidecar file's contents (8 byte aligned, e.g. an
+//       mmap), gj_False if it isn't one
+static int  gjson_index_open(GJSON_Index* index, const void* data, size_t size);
+
+// NOTE: Both set up gjson's parse stack so gjson_search can continue from the
+//       returned offset into the indexed data.
+static size_t gjson_index_seek_record(GJSON_State* gjson, GJSON_Index* index, u64 record);
+// NOTE: Resumes from the last record start or snapshot at or before offset
+static size_t gjson_index_seek(GJSON_State* gjson, GJSON_Index* index, size_t offset);
+// NOTE: Byte range of part part_index when splitting the records into
+//       part_count parts. Search it after gjson_index_seek(gjson, index, span.start).
+static GJSON_Span gjson_index_split(GJSON_Index* index, int part_index, int part_count);
+
+//////////////////////////////////////////////////////////////////////
+// Build
+//////////////////////////////////////////////////////////////////////
+#define GJSON_INDEX_MAGIC   0x31494A47 // NOTE: "GJI1"
+#define GJSON_INDEX_VERSION 1
+
+typedef struct JSONIndexHeader
+{
+    u32 magic;
+    u32 version;
+    u32 layout;
+    u32 pad;
+    u64 data_size;
+    u64 snapshot_interval;
+    u64 record_count;
+    u64 snapshot_count;
+} JSONIndexHeader;
+
+static void gjson_index_record_start_state(GJSON_IndexLayout layout, JSONParseQueue* queue)
+{
+    gjson_parse_queue_clear(queue);
+    if (layout == GJSON_IndexLayout_ArrayElements) queue->queue[queue->count++] = JSONStateType_Array;
+}
+
+static inline size_t gjson_index_skip_whitespace(const char* data, size_t size, size_t cursor)
+{
+    while (cursor < size && gj_IsWhitespace(data[cursor])) cursor++;
+    return cursor;
+}
+
+// NOTE: Parses the record from start to each snapshot boundary before end
+static int gjson_index_snapshot_record(GJSON_State* gjson, GJSON_Index* index, size_t snapshot_capacity,
+                                       const char* data, size_t start, size_t end, u64* next_snapshot)
+{
+    GJSON_Query query;
+    gj_ZeroMemory(&query);
+    query.type = GJSON_QueryType_ObjectKeys;
+
+    JSONParseQueue queue;
+    gjson_index_record_start_state(index->layout, &queue);
+
+    JSONParseData  json_parse_data;
+    GJSON_QueryKey single_key;
+    gjson_parse_data_init(&json_parse_data, gjson, query, &single_key);
+    json_parse_data.data        = (char*)data;
+    json_parse_data.cursor      = start;
+    json_parse_data.parse_queue = &queue;
+
+    while (*next_snapshot < end)
+    {
+        json_parse_data.size = (size_t)*next_snapshot;
+        if (gjson_parse(&json_parse_data) == JSONParseResult_Error) return gj_False;
+        // NOTE: Key match progress is query specific, move past the key
+        while (json_parse_data.cursor < end &&
+               (queue.state == JSONLexState_Key || queue.state == JSONLexState_KeyEscape))
+        {
+            json_parse_data.size = json_parse_data.cursor + 1;
+            if (gjson_parse(&json_parse_data) == JSONParseResult_Error) return gj_False;
+        }
+
+        if (index->snapshot_count == snapshot_capacity) return gj_False;
+        GJSON_IndexSnapshot* snapshot = &index->snapshots[index->snapshot_count++];
+        gj_ZeroMemory(snapshot);
+        snapshot->offset = json_parse_data.cursor;
+        snapshot->record = index->record_count - 1;
+        snapshot->state  = queue.state;
+        snapshot->depth  = (u8)queue.count;
+        memcpy(snapshot->stack, queue.queue, queue.count);
+
+        while (*next_snapshot <= json_parse_data.cursor) *next_snapshot += index->snapshot_interval;
+    }
+    return gj_True;
+}
+
+static void gjson_index_restore(GJSON_State* gjson, GJSON_Index* index, GJSON_IndexSnapshot* snapshot)
+{
+    JSONParseQueue* queue = gjson->parse_queue;
+    if (snapshot)
+    {
+        gjson_parse_queue_clear(queue);
+        memcpy(queue->queue, snapshot->stack, snapshot->depth);
+        queue->count = snapshot->depth;
+        queue->state = snapshot->state;
+    }
+    else gjson_index_record_start_state(index->layout, queue);
+}
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static int gjson_index_build(GJSON_State* gjson, GJSON_Index* index, const void* data, size_t size,
+                             GJSON_IndexLayout layout, size_t snapshot_interval)
+{
+    gj_ZeroMemory(index);
+    index->layout            = layout;
+    index->data_size         = size;
+    index->snapshot_interval = snapshot_interval;
+
+    MemoryArena* arena = &gjson->memory_arena;
+    size_t snapshot_capacity = snapshot_interval ? size / snapshot_interval + 1 : 0;
+    index->snapshots = PushArray(arena, snapshot_capacity, GJSON_IndexSnapshot);
+    // NOTE: Slack for arena alignment
+    size_t free_size       = arena->size - arena->used;
+    size_t record_capacity = free_size > 64 ? (free_size - 64) / sizeof(u64) : 0;
+    index->record_offsets  = PushArray(arena, record_capacity, u64);
+
+    const char* json   = (const char*)data;
+    size_t      cursor = gjson_index_skip_whitespace(json, size, 0);
+    u64 next_snapshot  = snapshot_interval ? snapshot_interval : (u64)-1;
+    int result         = gj_True;
+    // NOTE: Top-level array seen through its closing bracket, a truncated one is malformed
+    int closed         = layout != GJSON_IndexLayout_ArrayElements;
+
+    if (layout == GJSON_IndexLayout_ArrayElements)
+    {
+        if (cursor == size || json[cursor] != GJSON_ARRAY_START) result = gj_False;
+        cursor = gjson_index_skip_whitespace(json, size, cursor + 1);
+        if (cursor < size && json[cursor] == GJSON_ARRAY_END)
+        {
+            closed = gj_True;
+            cursor = size;
+        }
+    }
+
+    while (result && cursor < size)
+    {
+        int    complete;
+        size_t start = cursor;
+        size_t end   = gjson_skip_value_bytes(json, size, start, &complete);
+        if (end == start || !complete || index->record_count == record_capacity)
+        {
+            result = gj_False;
+            break;
+        }
+        index->record_offsets[index->record_count++] = start;
+
+        while (next_snapshot <= start) next_snapshot += snapshot_interval;
+        if (next_snapshot < end)
+        {
+            result = gjson_index_snapshot_record(gjson, index, snapshot_capacity, json, start, end, &next_snapshot);
+        }
+
+        cursor = gjson_index_skip_whitespace(json, size, end);
+        if (layout == GJSON_IndexLayout_ArrayElements && cursor < size)
+        {
+            char c = json[cursor];
+            if      (c == GJSON_ELEMENT_SEPARATOR) cursor = gjson_index_skip_whitespace(json, size, cursor + 1);
+            else if (c == GJSON_ARRAY_END)
+            {
+                closed = gj_True;
+                cursor = size;
+            }
+            else result = gj_False;
+        }
+    }
+    if (!closed) result = gj_False;
+
+    arena->used -= (record_capacity - index->record_count) * sizeof(u64);
+    return result;
+}
+
+static void gjson_index_write(GJSON_Index* index, GJSON_Writer* writer)
+{
+    JSONIndexHeader header;
+    gj_ZeroMemory(&header);
+    header.magic             = GJSON_INDEX_MAGIC;
+    header.version           = GJSON_INDEX_VERSION;
+    header.layout            = (u32)index->layout;
+    header.data_size         = index->data_size;
+    header.snapshot_interval = index->snapshot_interval;
+    header.record_count      = index->record_count;
+    header.snapshot_count    = index->snapshot_count;
+
+    gjson_writer_put(writer, (const char*)&header, sizeof(header));
+    gjson_writer_put(writer, (const char*)index->record_offsets, index->record_count * sizeof(u64));
+    gjson_writer_put(writer, (const char*)index->snapshots, index->snapshot_count * sizeof(GJSON_IndexSnapshot));
+}
+
+static int gjson_index_open(GJSON_Index* index, const void* data, size_t size)
+{
+    gj_ZeroMemory(index);
+    JSONIndexHeader header;
+    if (size < sizeof(header)) return gj_False;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != GJSON_INDEX_MAGIC || header.version != GJSON_INDEX_VERSION) return gj_False;
+    if (header.record_count   > (size - sizeof(header)) / sizeof(u64)) return gj_False;
+    if (header.snapshot_count > (size - sizeof(header) - header.record_count * sizeof(u64)) / sizeof(GJSON_IndexSnapshot)) return gj_False;
+
+    index->layout            = (GJSON_IndexLayout)header.layout;
+    index->data_size         = header.data_size;
+    index->snapshot_interval = header.snapshot_interval;
+    index->record_count      = header.record_count;
+    index->record_offsets    = (u64*)((u8*)data + sizeof(header));
+    index->snapshot_count    = header.snapshot_count;
+    index->snapshots         = (GJSON_IndexSnapshot*)(index->record_offsets + header.record_count);
+    return gj_True;
+}
+
+static size_t gjson_index_seek_record(GJSON_State* gjson, GJSON_Index* index, u64 record)
+{
+    if (record >= index->record_count)
+    {
+        // NOTE: Past the last record, nothing left to find
+        gjson_parse_queue_clear(gjson->parse_queue);
+        return (size_t)index->data_size;
+    }
+    gjson_index_restore(gjson, index, NULL);
+    return (size_t)index->record_offsets[record];
+}
+
+static size_t gjson_index_seek(GJSON_State* gjson, GJSON_Index* index, size_t offset)
+{
+    // NOTE: Last record starting at or before offset
+    u64 low  = 0;
+    u64 high = index->record_count;
+    while (low < high)
+    {
+        u64 middle = low + (high - low) / 2;
+        if (index->record_offsets[middle] <= offset) low  = middle + 1;
+        else                                         high = middle;
+    }
+    if (low == 0) return gjson_index_seek_record(gjson, index, 0);
+    u64 record = low - 1;
+
+    // NOTE: Last snapshot inside that record at or before offset
+    GJSON_IndexSnapshot* snapshot = NULL;
+    low  = 0;
+    high = index->snapshot_count;
+    while (low < high)
+    {
+        u64 middle = low + (high - low) / 2;
+        if (index->snapshots[middle].offset <= offset) low  = middle + 1;
+        else                                           high = middle;
+    }
+    if (low > 0 && index->snapshots[low - 1].record == record) snapshot = &index->snapshots[low - 1];
+
+    if (!snapshot) return gjson_index_seek_record(gjson, index, record);
+    gjson_index_restore(gjson, index, snapshot);
+    return (size_t)snapshot->offset;
+}
+
+static GJSON_Span gjson_index_split(GJSON_Index* index, int part_index, int part_count)
+{
+    gj_Assert(part_index >= 0 && part_index < part_count);
+    u64 begin = (index->record_count * (u64)part_index)       / (u64)part_count;
+    u64 end   = (index->record_count * (u64)(part_index + 1)) / (u64)part_count;
+
+    GJSON_Span result;
+    result.start = begin < index->record_count ? (size_t)index->record_offsets[begin] : (size_t)index->data_size;
+    result.end   = end   < index->record_count ? (size_t)index->record_offsets[end]   : (size_t)index->data_size;
+    return result;
+}
+
+#endif
@@ -0,0 +1,458 @@
+#if !defined(JSON_QUERY_H)
+#define JSON_QUERY_H
+
+#include <stdlib.h>
+
+#include "json.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef enum GJSON_PredicateType
+{
+    // NOTE: Compared against the raw bytes between the quotes, escaped
+    //       values never match
+    GJSON_PredicateType_StringEquals,
+    GJSON_PredicateType_StringPrefix,
+    // NOTE: minimum <= value <= maximum
+    GJSON_PredicateType_NumberRange,
+    GJSON_PredicateType_True,
+    GJSON_PredicateType_False,
+    GJSON_PredicateType_Null
+} GJSON_PredicateType;
+
+typedef struct GJSON_Predicate
+{
+    GJSON_PredicateType type;
+    union
+    {
+        struct
+        {
+            int   string_length;
+            char* string;
+        };
+        struct
+        {
+            f64 minimum;
+            f64 maximum;
+        };
+    };
+} GJSON_Predicate;
+
+typedef struct GJSON_KeyValueQuery
+{
+    // NOTE: GJSON_QueryType_ObjectKey or _ObjectKeys
+    GJSON_Query     key;
+    GJSON_Predicate predicate;
+    // NOTE: Top-level values are one per line (NDJSON), lets the prefilter
+    //       jump straight to the line holding the next candidate
+    int             newline_delimited;
+} GJSON_KeyValueQuery;
+
+typedef struct GJSON_KeyValueResult
+{
+    // NOTE: Hit, Error or NeedMoreBytes once data is exhausted
+    GJSON_QueryResultType type;
+    size_t                read_bytes;
+    // NOTE: Hit only, relative to gjson->data
+    GJSON_Span            value;
+    int                   key_index;
+} GJSON_KeyValueResult;
+
+typedef enum GJSON_AggregateType
+{
+    GJSON_AggregateType_Count,
+    // NOTE: Stops at the first hit
+    GJSON_AggregateType_Exists,
+    // NOTE: Stops once first_capacity value spans are stored
+    GJSON_AggregateType_FirstN,
+    // NOTE: Over values that are numbers, others are skipped
+    GJSON_AggregateType_Sum,
+    GJSON_AggregateType_Min,
+    GJSON_AggregateType_Max
+} GJSON_AggregateType;
+
+typedef struct GJSON_Aggregate
+{
+    GJSON_AggregateType type;
+    GJSON_Query         query;
+    GJSON_Span*         first_spans;
+    size_t              first_capacity;
+
+    // NOTE: Accumulated across calls, zero before the first one. count is
+    //       hits (numbers aggregated for Sum/Min/Max, spans stored for
+    //       FirstN), spans and read_bytes are offsets into all data so far.
+    u64    count;
+    f64    value;
+    size_t read_bytes;
+} GJSON_Aggregate;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: Like gjson_search but only hits when the member's value satisfies
+//       query->predicate. gjson->data must hold the complete input (whole
+//       document, NDJSON or an mmap): before parsing, the literal value (or
+//       the quoted key for non-string predicates) is located with
+//       gjson_memmem and input without candidates is never parsed.
+static GJSON_KeyValueResult gjson_search_key_value(GJSON_State* gjson, GJSON_KeyValueQuery* query);
+// NOTE: Same results as gjson_search for a single GJSON_QueryType_ObjectKey
+//       on complete, valid input, without running the parser: the quoted key
+//       is located with gjson_memmem and confirmed as a key by checking its
+//       opening quote isn't escaped and a colon follows. Doesn't touch the
+//       parse stack, so hits can't be followed by gjson_skip_member_value.
+static GJSON_QueryResult gjson_search_raw_key(GJSON_State* gjson, GJSON_Query query);
+// NOTE: Evaluates aggregate over all of gjson->data in one call. Count and
+//       Exists are resumable across buffers like gjson_search. The others
+//       need each matched member whole in one buffer: when data ends inside
+//       one they stop before its key with aggregate->read_bytes at the key,
+//       pass data again from there with more bytes after it (a buffer must
+//       fit the largest matched member). Returns NeedMoreBytes once data is
+//       exhausted, Hit when Exists/FirstN finished early or Error.
+static GJSON_QueryResultType gjson_aggregate(GJSON_State* gjson, GJSON_Aggregate* aggregate);
+
+//////////////////////////////////////////////////////////////////////
+// Predicates
+//////////////////////////////////////////////////////////////////////
+static int gjson_value_number(const char* value, size_t value_size, f64* number)
+{
+    char buffer[64];
+    if (value_size == 0 || value_size >= sizeof(buffer)) return gj_False;
+    if (value[0] != GJSON_SIGN_NEGATIVE && !gj_IsDigit(value[0])) return gj_False;
+    memcpy(buffer, value, value_size);
+    buffer[value_size] = 0;
+    *number = strtod(buffer, NULL);
+    return gj_True;
+}
+
+static int gjson_predicate_match(GJSON_Predicate* predicate, const char* value, size_t value_size)
+{
+    switch (predicate->type)
+    {
+        case GJSON_PredicateType_StringEquals:
+        case GJSON_PredicateType_StringPrefix:
+        {
+            if (value_size < 2 || value[0] != GJSON_STRING) return gj_False;
+            const char* string      = value + 1;
+            size_t      string_size = value_size - 2;
+            size_t      length      = (size_t)predicate->string_length;
+            if (predicate->type == GJSON_PredicateType_StringEquals && string_size != length) return gj_False;
+            return string_size >= length && memcmp(string, predicate->string, length) == 0;
+        }
+
+        case GJSON_PredicateType_NumberRange:
+        {
+            f64 number;
+            if (!gjson_value_number(value, value_size, &number)) return gj_False;
+            return number >= predicate->minimum && number <= predicate->maximum;
+        }
+
+        case GJSON_PredicateType_True:  return value_size == sizeof(GJSON_TRUE)  - 1 && memcmp(value, GJSON_TRUE,  value_size) == 0;
+        case GJSON_PredicateType_False: return value_size == sizeof(GJSON_FALSE) - 1 && memcmp(value, GJSON_FALSE, value_size) == 0;
+        case GJSON_PredicateType_Null:  return value_size == sizeof(GJSON_NULL)  - 1 && memcmp(value, GJSON_NULL,  value_size) == 0;
+
+        InvalidDefaultCase;
+    }
+    return gj_False;
+}
+
+#define GJSON_NEEDLE_SIZE 256
+// NOTE: Quoted string value, or the quoted key when there's a single key and
+//       the predicate has no literal. Returns 0 when nothing can prefilter.
+static size_t gjson_predicate_needle(GJSON_KeyValueQuery* query, char* needle)
+{
+    const char* literal        = NULL;
+    size_t      literal_length = 0;
+    int         closing_quote  = gj_True;
+
+    GJSON_Predicate* predicate = &query->predicate;
+    if (predicate->type == GJSON_PredicateType_StringEquals ||
+        predicate->type == GJSON_PredicateType_StringPrefix)
+    {
+        literal        = predicate->string;
+        literal_length = (size_t)predicate->string_length;
+        closing_quote  = predicate->type == GJSON_PredicateType_StringEquals;
+    }
+    else if (query->key.type == GJSON_QueryType_ObjectKey)
+    {
+        literal        = query->key.string;
+        literal_length = (size_t)query->key.string_length;
+    }
+    else return 0;
+
+    if (literal_length + 2 > GJSON_NEEDLE_SIZE)
+    {
+        // NOTE: Unquoted prefix is still a valid, if weaker, needle
+        literal_length = GJSON_NEEDLE_SIZE;
+        memcpy(needle, literal, literal_length);
+        return literal_length;
+    }
+
+    size_t needle_length = 0;
+    needle[needle_length++] = GJSON_STRING;
+    memcpy(needle + needle_length, literal, literal_length);
+    needle_length += literal_length;
+    if (closing_quote) needle[needle_length++] = GJSON_STRING;
+    return needle_length;
+}
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_KeyValueResult gjson_search_key_value(GJSON_State* gjson, GJSON_KeyValueQuery* query)
+{
+    GJSON_KeyValueResult result;
+    gj_ZeroMemory(&result);
+
+    char*  data   = (char*)gjson->data;
+    size_t size   = gjson->size;
+    size_t cursor = 0;
+
+    char   needle[GJSON_NEEDLE_SIZE];
+    size_t needle_length = gjson_predicate_needle(query, needle);
+    // NOTE: Next needle at or past cursor, only searched again once the parser
+    //       has consumed it so key hits before it don't each rescan the gap
+    size_t candidate = 0;
+
+    while (gj_True)
+    {
+        if (needle_length > 0 && candidate <= cursor)
+        {
+            candidate = cursor + gjson_memmem(data + cursor, size - cursor, needle, needle_length);
+            if (candidate == size)
+            {
+                // NOTE: Nothing left can match
+                gjson_parse_queue_clear(gjson->parse_queue);
+                cursor = size;
+                result.type = GJSON_QueryResultType_NeedMoreBytes;
+                break;
+            }
+
+            if (query->newline_delimited)
+            {
+                size_t line_start = candidate;
+                while (line_start > cursor && data[line_start - 1] != '\n') line_start--;
+                // NOTE: Current record (if any) ends before the candidate's line
+                if (line_start > cursor)
+                {
+                    gjson_parse_queue_clear(gjson->parse_queue);
+                    cursor = line_start;
+                }
+            }
+        }
+
+        gjson->data = data + cursor;
+        gjson->size = size - cursor;
+        GJSON_QueryResult key_result = gjson_search(gjson, query->key);
+        cursor += key_result.read_bytes;
+        if (key_result.type != GJSON_QueryResultType_Hit)
+        {
+            result.type = key_result.type;
+            break;
+        }
+
+        gjson->data = data + cursor;
+        gjson->size = size - cursor;
+        GJSON_Span value;
+        if (gjson_skip_member_value(gjson, &value) != GJSON_QueryResultType_Hit)
+        {
+            // NOTE: data is complete, a value cut off at its end is malformed too
+            gjson->parse_queue->state = JSONLexState_Error;
+            result.type = GJSON_QueryResultType_Error;
+            break;
+        }
+        value.start += cursor;
+        value.end   += cursor;
+        if (data[value.start] == GJSON_OBJECT_START || data[value.start] == GJSON_ARRAY_START)
+        {
+            // NOTE: Predicates only match scalars but nested keys may still hit
+            gjson->parse_queue->state = JSONLexState_Colon;
+            continue;
+        }
+        cursor = value.end;
+
+        if (gjson_predicate_match(&query->predicate, data + value.start, value.end - value.start))
+        {
+            result.type      = GJSON_QueryResultType_Hit;
+            result.value     = value;
+            result.key_index = key_result.key_index;
+            break;
+        }
+    }
+
+    gjson->data = data;
+    gjson->size = size;
+    result.read_bytes = cursor;
+    return result;
+}
+
+static GJSON_QueryResult gjson_search_raw_key(GJSON_State* gjson, GJSON_Query query)
+{
+    gj_Assert(query.type == GJSON_QueryType_ObjectKey && query.string_length + 2 <= GJSON_NEEDLE_SIZE);
+
+    GJSON_QueryResult result;
+    gj_ZeroMemory(&result);
+
+    const char* data = (const char*)gjson->data;
+    size_t      size = gjson->size;
+
+    char   needle[GJSON_NEEDLE_SIZE];
+    size_t needle_length = 0;
+    needle[needle_length++] = GJSON_STRING;
+    memcpy(needle + needle_length, query.string, query.string_length);
+    needle_length += query.string_length;
+    needle[needle_length++] = GJSON_STRING;
+
+    size_t cursor = 0;
+    while (cursor < size)
+    {
+        size_t candidate = cursor + gjson_memmem(data + cursor, size - cursor, needle, needle_length);
+        if (candidate == size) break;
+        cursor = candidate + 1;
+
+        // NOTE: An unescaped quote always delimits a string, so an odd
+        //       backslash run means we're inside a string value
+        size_t backslashes = 0;
+        while (backslashes < candidate && data[candidate - backslashes - 1] == '\\') backslashes++;
+        if (backslashes & 1) continue;
+
+        // NOTE: A string followed by a colon is a key
+        size_t after = candidate + needle_length;
+        while (after < size && gj_IsWhitespace(data[after])) after++;
+        if (after < size && data[after] == GJSON_MEMBER_COLON)
+        {
+            result.type        = GJSON_QueryResultType_Hit;
+            result.read_bytes  = candidate + needle_length;
+            result.match_start = candidate;
+            return result;
+        }
+    }
+
+    result.type       = GJSON_QueryResultType_NeedMoreBytes;
+    result.read_bytes = size;
+    return result;
+}
+
+// NOTE: Cursor just past a matched key, gj_False if data ends before the value
+static int gjson_member_value_is_container(const char* data, size_t size, size_t cursor)
+{
+    while (cursor < size && gj_IsWhitespace(data[cursor])) cursor++;
+    if (cursor == size || data[cursor] != GJSON_MEMBER_COLON) return gj_False;
+    cursor++;
+    while (cursor < size && gj_IsWhitespace(data[cursor])) cursor++;
+    return cursor < size && (data[cursor] == GJSON_OBJECT_START || data[cursor] == GJSON_ARRAY_START);
+}
+
+static GJSON_QueryResultType gjson_aggregate(GJSON_State* gjson, GJSON_Aggregate* aggregate)
+{
+    gj_Assert(aggregate->type != GJSON_AggregateType_FirstN || aggregate->count < aggregate->first_capacity);
+
+    JSONParseData  json_parse_data;
+    GJSON_QueryKey single_key;
+    gjson_parse_data_init(&json_parse_data, gjson, aggregate->query, &single_key);
+    // NOTE: Count never needs the value, hits are tallied inside gjson_parse
+    json_parse_data.count_hits = aggregate->type == GJSON_AggregateType_Count;
+    // NOTE: Matched members are read whole, see the API note
+    int whole_members = aggregate->type != GJSON_AggregateType_Count && aggregate->type != GJSON_AggregateType_Exists;
+
+    GJSON_QueryResultType result = GJSON_QueryResultType_NeedMoreBytes;
+    JSONParseQueue*       queue  = gjson->parse_queue;
+    while (gj_True)
+    {
+        JSONParseResult parse_result = gjson_parse(&json_parse_data);
+        if (parse_result == JSONParseResult_OutOfBytes)
+        {
+            if (whole_members && queue->state == JSONLexState_Key && queue->string_match)
+            {
+                // NOTE: Key may still match, start over from its opening quote
+                queue->state = JSONLexState_ObjectKey;
+                json_parse_data.cursor = json_parse_data.match_start;
+            }
+            break;
+        }
+        if (parse_result == JSONParseResult_Error)
+        {
+            result = GJSON_QueryResultType_Error;
+            break;
+        }
+
+        if (aggregate->type == GJSON_AggregateType_Exists)
+        {
+            aggregate->count++;
+            result = GJSON_QueryResultType_Hit;
+            break;
+        }
+
+        char*  data   = json_parse_data.data;
+        size_t cursor = json_parse_data.cursor;
+        gjson->data = data + cursor;
+        gjson->size = json_parse_data.size - cursor;
+        GJSON_Span value;
+        GJSON_QueryResultType skip = gjson_skip_member_value(gjson, &value);
+        if (skip == GJSON_QueryResultType_Error)
+        {
+            result = GJSON_QueryResultType_Error;
+            break;
+        }
+        if (skip == GJSON_QueryResultType_NeedMoreBytes)
+        {
+            if (aggregate->type != GJSON_AggregateType_FirstN &&
+                gjson_member_value_is_container(data, json_parse_data.size, cursor))
+            {
+                // NOTE: Not a number, only its nested keys matter
+                queue->state = JSONLexState_Colon;
+                continue;
+            }
+            // NOTE: Value continues in the next buffer, start over from the key
+            queue->state = JSONLexState_ObjectKey;
+            json_parse_data.cursor = json_parse_data.match_start;
+            break;
+        }
+        value.start += cursor;
+        value.end   += cursor;
+        if (data[value.start] == GJSON_OBJECT_START || data[value.start] == GJSON_ARRAY_START)
+        {
+            // NOTE: Let the parser walk into containers so nested keys still hit
+            queue->state = JSONLexState_Colon;
+        }
+        else json_parse_data.cursor = value.end;
+
+        if (aggregate->type == GJSON_AggregateType_FirstN)
+        {
+            GJSON_Span* span = &aggregate->first_spans[aggregate->count++];
+            span->start = aggregate->read_bytes + value.start;
+            span->end   = aggregate->read_bytes + value.end;
+            if (aggregate->count == aggregate->first_capacity)
+            {
+                result = GJSON_QueryResultType_Hit;
+                break;
+            }
+            continue;
+        }
+
+        f64 number;
+        if (!gjson_value_number(data + value.start, value.end - value.start, &number)) continue;
+        switch (aggregate->type)
+        {
+            case GJSON_AggregateType_Sum: aggregate->value += number; break;
+            case GJSON_AggregateType_Min:
+            {
+                if (aggregate->count == 0 || number < aggregate->value) aggregate->value = number;
+            } break;
+            case GJSON_AggregateType_Max:
+            {
+                if (aggregate->count == 0 || number > aggregate->value) aggregate->value = number;
+            } break;
+            InvalidDefaultCase;
+        }
+        aggregate->count++;
+    }
+
+    aggregate->count      += json_parse_data.hit_count;
+    aggregate->read_bytes += json_parse_data.cursor;
+    gjson->data = json_parse_data.data;
+    gjson->size = json_parse_data.size;
+    return result;
+}
+
+#endif
@@ -0,0 +1,363 @@
+#if !defined(JSON_STREAM_H)
+#define JSON_STREAM_H
+
+#include "json.h"
+#include "json_thread.h"
+
+// NOTE: Define GJSON_ZLIB and/or GJSON_ZSTD to 1 and link zlib/libzstd
+//       to enable the matching GJSON_Compression.
+#if !defined(GJSON_ZLIB)
+#define GJSON_ZLIB 0
+#endif
+#if !defined(GJSON_ZSTD)
+#define GJSON_ZSTD 0
+#endif
+
+#if GJSON_ZLIB
+#include <zlib.h>
+#endif
+#if GJSON_ZSTD
+#include <zstd.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+typedef enum GJSON_Compression
+{
+    GJSON_Compression_None,
+    // NOTE: gzip or zlib, concatenated gzip members are followed
+    GJSON_Compression_Gzip,
+    GJSON_Compression_Zstd
+} GJSON_Compression;
+
+// NOTE: Reads up to buffer_size compressed bytes, returns 0 at end of input
+typedef size_t GJSON_StreamRead(void* user_data, void* buffer, size_t buffer_size);
+
+typedef struct GJSON_StreamChunk
+{
+    char*  data;
+    size_t size;
+} GJSON_StreamChunk;
+
+typedef struct GJSON_Stream
+{
+    GJSON_Compression compression;
+    GJSON_StreamRead* read;
+    void*             read_user_data;
+    char*             input;
+    size_t            input_size;
+
+    // NOTE: Ring of decompressed chunks, slot = count % chunk_count
+    GJSON_StreamChunk* chunks;
+    int                chunk_count;
+    size_t             chunk_size;
+    u64                write_count;
+    u64                read_count;
+    int                done;
+    int                error;
+    int                quit;
+    GJSON_Mutex        mutex;
+    GJSON_Condition    not_empty;
+    GJSON_Condition    not_full;
+    GJSON_Thread       thread;
+
+    // NOTE: Consumer side
+    GJSON_StreamChunk* current;
+    size_t             current_offset;
+    size_t             stream_offset;
+} GJSON_Stream;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+// NOTE: Starts a thread that decompresses into chunk_count chunks of
+//       chunk_size bytes, all pushed from gjson->memory_arena.
+static GJSON_Stream* gjson_stream_open(GJSON_State* gjson, GJSON_Compression compression,
+                                       GJSON_StreamRead* read, void* read_user_data,
+                                       int chunk_count, size_t chunk_size);
+// NOTE: Runs gjson_search over decompressed chunks as they arrive. Returns
+//       gj_True on a Hit with result->read_bytes as the offset just past the
+//       key in the decompressed stream (match_start is not translated),
+//       gj_False once the input is exhausted or on an error.
+static int  gjson_stream_search(GJSON_Stream* stream, GJSON_State* gjson, GJSON_Query query, GJSON_QueryResult* result);
+// NOTE: Non-zero if decompression failed, the compression is not compiled in
+//       or the JSON was malformed or ended inside a value
+static int  gjson_stream_error (GJSON_Stream* stream);
+static void gjson_stream_close (GJSON_Stream* stream);
+
+//////////////////////////////////////////////////////////////////////
+// Decompression
+//////////////////////////////////////////////////////////////////////
+typedef struct GJSON_StreamDecoder
+{
+    size_t input_used;
+    size_t input_available;
+    int    input_done;
+    // NOTE: Inside a gzip member or zstd frame, input ending here is truncated
+    int    in_frame;
+#if GJSON_ZLIB
+    z_stream zlib;
+#endif
+#if GJSON_ZSTD
+    ZSTD_DStream* zstd;
+#endif
+} GJSON_StreamDecoder;
+
+static int gjson_stream_read_input(GJSON_Stream* stream, GJSON_StreamDecoder* decoder)
+{
+    if (decoder->input_used < decoder->input_available) return gj_True;
+    if (decoder->input_done) return gj_False;
+
+    decoder->input_used      = 0;
+    decoder->input_available = stream->read(stream->read_user_data, stream->input, stream->input_size);
+    if (decoder->input_available == 0) decoder->input_done = gj_True;
+    return decoder->input_available > 0;
+}
+
+// NOTE: Fills chunk up to chunk_size, returns gj_False at end of input. A
+//       decoder can still hold output after its last input, it is drained
+//       until the member/frame ends or stops making progress.
+static int gjson_stream_fill(GJSON_Stream* stream, GJSON_StreamDecoder* decoder, GJSON_StreamChunk* chunk)
+{
+    chunk->size = 0;
+    while (chunk->size < stream->chunk_size)
+    {
+        if (stream->compression == GJSON_Compression_None)
+        {
+            size_t read_bytes = stream->read(stream->read_user_data, chunk->data + chunk->size, stream->chunk_size - chunk->size);
+            if (read_bytes == 0) return gj_False;
+            chunk->size += read_bytes;
+            continue;
+        }
+
+        int has_input = gjson_stream_read_input(stream, decoder);
+        if (!has_input && !decoder->in_frame) return gj_False;
+        size_t chunk_used = chunk->size;
+
+        switch (stream->compression)
+        {
+#if GJSON_ZLIB
+            case GJSON_Compression_Gzip:
+            {
+                char*     input      = stream->input + decoder->input_used;
+                size_t    input_size = decoder->input_available - decoder->input_used;
+                z_stream* zlib  = &decoder->zlib;
+                zlib->next_in   = (Bytef*)input;
+                zlib->avail_in  = (uInt)gj_Min(input_size, (size_t)0xFFFFFFFF);
+                zlib->next_out  = (Bytef*)(chunk->data + chunk->size);
+                zlib->avail_out = (uInt)(stream->chunk_size - chunk->size);
+                uInt avail_in  = zlib->avail_in;
+                uInt avail_out = zlib->avail_out;
+                int  status    = inflate(zlib, Z_NO_FLUSH);
+                decoder->input_used += avail_in  - zlib->avail_in;
+                chunk->size         += avail_out - zlib->avail_out;
+                if (avail_in != zlib->avail_in) decoder->in_frame = gj_True;
+                if (status == Z_STREAM_END)
+                {
+                    // NOTE: Concatenated gzip members
+                    inflateReset(zlib);
+                    decoder->in_frame = gj_False;
+                }
+                else if (status != Z_OK && status != Z_BUF_ERROR)
+                {
+                    stream->error = status;
+                    return gj_False;
+                }
+            } break;
+#endif
+#if GJSON_ZSTD
+            case GJSON_Compression_Zstd:
+            {
+                char*          input      = stream->input + decoder->input_used;
+                size_t         input_size = decoder->input_available - decoder->input_used;
+                ZSTD_inBuffer  in  = { input, input_size, 0 };
+                ZSTD_outBuffer out = { chunk->data + chunk->size, stream->chunk_size - chunk->size, 0 };
+                size_t status = ZSTD_decompressStream(decoder->zstd, &out, &in);
+                if (ZSTD_isError(status))
+                {
+                    stream->error = -1;
+                    return gj_False;
+                }
+                decoder->input_used += in.pos;
+                chunk->size         += out.pos;
+                // NOTE: 0 once a frame is fully decoded and flushed
+                if (in.pos > 0 || out.pos > 0) decoder->in_frame = status != 0;
+            } break;
+#endif
+            default:
+            {
+                // NOTE: Compression not compiled in
+                stream->error = -1;
+                return gj_False;
+            } break;
+        }
+
+        if (!has_input && chunk->size == chunk_used)
+        {
+            // NOTE: Input ended inside a member/frame
+            stream->error = -1;
+            return gj_False;
+        }
+    }
+    return gj_True;
+}
+
+static GJSON_THREAD_PROC(gjson_stream_thread_proc)
+{
+    GJSON_Stream* stream = (GJSON_Stream*)parameter;
+
+    GJSON_StreamDecoder decoder;
+    gj_ZeroMemory(&decoder);
+#if GJSON_ZLIB
+    if (stream->compression == GJSON_Compression_Gzip) inflateInit2(&decoder.zlib, 15 + 32);
+#endif
+#if GJSON_ZSTD
+    if (stream->compression == GJSON_Compression_Zstd) decoder.zstd = ZSTD_createDStream();
+#endif
+
+    int more = gj_True;
+    while (more)
+    {
+        gjson_mutex_lock(&stream->mutex);
+        while (!stream->quit && stream->write_count - stream->read_count == (u64)stream->chunk_count)
+        {
+            gjson_condition_wait(&stream->not_full, &stream->mutex);
+        }
+        int quit = stream->quit;
+        gjson_mutex_unlock(&stream->mutex);
+        if (quit) break;
+
+        GJSON_StreamChunk* chunk = &stream->chunks[stream->write_count % stream->chunk_count];
+        more = gjson_stream_fill(stream, &decoder, chunk);
+
+        gjson_mutex_lock(&stream->mutex);
+        if (chunk->size > 0) stream->write_count++;
+        gjson_condition_signal(&stream->not_empty);
+        gjson_mutex_unlock(&stream->mutex);
+    }
+
+#if GJSON_ZLIB
+    if (stream->compression == GJSON_Compression_Gzip) inflateEnd(&decoder.zlib);
+#endif
+#if GJSON_ZSTD
+    if (stream->compression == GJSON_Compression_Zstd) ZSTD_freeDStream(decoder.zstd);
+#endif
+
+    gjson_mutex_lock(&stream->mutex);
+    stream->done = gj_True;
+    gjson_condition_signal(&stream->not_empty);
+    gjson_mutex_unlock(&stream->mutex);
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consumer
+//////////////////////////////////////////////////////////////////////
+static int gjson_stream_acquire(GJSON_Stream* stream)
+{
+    gjson_mutex_lock(&stream->mutex);
+    while (!stream->done && stream->write_count == stream->read_count)
+    {
+        gjson_condition_wait(&stream->not_empty, &stream->mutex);
+    }
+    int available = stream->write_count != stream->read_count;
+    gjson_mutex_unlock(&stream->mutex);
+
+    if (available)
+    {
+        stream->current        = &stream->chunks[stream->read_count % stream->chunk_count];
+        stream->current_offset = 0;
+    }
+    return available;
+}
+
+static void gjson_stream_release(GJSON_Stream* stream)
+{
+    stream->stream_offset += stream->current->size;
+    stream->current = NULL;
+
+    gjson_mutex_lock(&stream->mutex);
+    stream->read_count++;
+    gjson_condition_signal(&stream->not_full);
+    gjson_mutex_unlock(&stream->mutex);
+}
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_Stream* gjson_stream_open(GJSON_State* gjson, GJSON_Compression compression,
+                                       GJSON_StreamRead* read, void* read_user_data,
+                                       int chunk_count, size_t chunk_size)
+{
+    gj_Assert(chunk_count > 1 && chunk_size > 0);
+    GJSON_Stream* stream = PushStruct(&gjson->memory_arena, GJSON_Stream);
+    gj_ZeroMemory(stream);
+    stream->compression    = compression;
+    stream->read           = read;
+    stream->read_user_data = read_user_data;
+    stream->input_size     = chunk_size;
+    stream->input          = (char*)PushSize(&gjson->memory_arena, stream->input_size);
+    stream->chunk_count    = chunk_count;
+    stream->chunk_size     = chunk_size;
+    stream->chunks         = PushArray(&gjson->memory_arena, chunk_count, GJSON_StreamChunk);
+    for (int i = 0; i < chunk_count; i++)
+    {
+        stream->chunks[i].data = (char*)PushSize(&gjson->memory_arena, chunk_size);
+        stream->chunks[i].size = 0;
+    }
+    gjson_mutex_init(&stream->mutex);
+    gjson_condition_init(&stream->not_empty);
+    gjson_condition_init(&stream->not_full);
+    stream->thread = gjson_thread_create(gjson_stream_thread_proc, stream);
+    return stream;
+}
+
+static int gjson_stream_search(GJSON_Stream* stream, GJSON_State* gjson, GJSON_Query query, GJSON_QueryResult* result)
+{
+    while (gj_True)
+    {
+        if (!stream->current && !gjson_stream_acquire(stream))
+        {
+            // NOTE: A stream cut off inside a value decompresses cleanly
+            if (!stream->error && !gjson_parse_queue_complete(gjson->parse_queue)) stream->error = -1;
+            return gj_False;
+        }
+
+        gjson->data = stream->current->data + stream->current_offset;
+        gjson->size = stream->current->size - stream->current_offset;
+        GJSON_QueryResult query_result = gjson_search(gjson, query);
+        stream->current_offset += query_result.read_bytes;
+
+        if (query_result.type == GJSON_QueryResultType_Hit)
+        {
+            *result = query_result;
+            result->read_bytes  = stream->stream_offset + stream->current_offset;
+            result->match_start = 0;
+            if (stream->current_offset == stream->current->size) gjson_stream_release(stream);
+            return gj_True;
+        }
+        if (query_result.type == GJSON_QueryResultType_Error)
+        {
+            stream->error = -1;
+            return gj_False;
+        }
+        gjson_stream_release(stream);
+    }
+}
+
+static int gjson_stream_error(GJSON_Stream* stream)
+{
+    return stream->error;
+}
+
+static void gjson_stream_close(GJSON_Stream* stream)
+{
+    gjson_mutex_lock(&stream->mutex);
+    stream->quit = gj_True;
+    gjson_condition_signal(&stream->not_full);
+    gjson_mutex_unlock(&stream->mutex);
+    gjson_thread_join(stream->thread);
+}
+
+#endif
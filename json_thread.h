@@ -0,0 +1,61 @@
+#if !defined(JSON_THREAD_H)
+#define JSON_THREAD_H
+
+#include "json.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Threads/Atomics
+//////////////////////////////////////////////////////////////////////
+#if defined(_WIN32)
+typedef HANDLE             GJSON_Thread;
+typedef CRITICAL_SECTION   GJSON_Mutex;
+typedef CONDITION_VARIABLE GJSON_Condition;
+#define GJSON_THREAD_PROC(Name) DWORD WINAPI Name(void* parameter)
+
+static inline u64  gjson_atomic_load_u64(volatile u64* value) { return (u64)InterlockedCompareExchange64((volatile LONG64*)value, 0, 0); }
+static inline void gjson_atomic_store_u64(volatile u64* value, u64 new_value) { InterlockedExchange64((volatile LONG64*)value, (LONG64)new_value); }
+static inline int  gjson_atomic_cas_u64(volatile u64* value, u64 expected, u64 new_value)
+{
+    return (u64)InterlockedCompareExchange64((volatile LONG64*)value, (LONG64)new_value, (LONG64)expected) == expected;
+}
+
+static void gjson_mutex_init(GJSON_Mutex* mutex)              { InitializeCriticalSection(mutex); }
+static void gjson_mutex_lock(GJSON_Mutex* mutex)              { EnterCriticalSection(mutex); }
+static void gjson_mutex_unlock(GJSON_Mutex* mutex)            { LeaveCriticalSection(mutex); }
+static void gjson_condition_init(GJSON_Condition* condition)  { InitializeConditionVariable(condition); }
+static void gjson_condition_wait(GJSON_Condition* condition, GJSON_Mutex* mutex) { SleepConditionVariableCS(condition, mutex, INFINITE); }
+static void gjson_condition_broadcast(GJSON_Condition* condition) { WakeAllConditionVariable(condition); }
+static void gjson_condition_signal(GJSON_Condition* condition) { WakeConditionVariable(condition); }
+static GJSON_Thread gjson_thread_create(LPTHREAD_START_ROUTINE proc, void* parameter) { return CreateThread(0, 0, proc, parameter, 0, 0); }
+static void gjson_thread_join(GJSON_Thread thread) { WaitForSingleObject(thread, INFINITE); CloseHandle(thread); }
+#else
+typedef pthread_t       GJSON_Thread;
+typedef pthread_mutex_t GJSON_Mutex;
+typedef pthread_cond_t  GJSON_Condition;
+#define GJSON_THREAD_PROC(Name) void* Name(void* parameter)
+
+static inline u64  gjson_atomic_load_u64(volatile u64* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+static inline void gjson_atomic_store_u64(volatile u64* value, u64 new_value) { __atomic_store_n(value, new_value, __ATOMIC_RELEASE); }
+static inline int  gjson_atomic_cas_u64(volatile u64* value, u64 expected, u64 new_value)
+{
+    return __atomic_compare_exchange_n(value, &expected, new_value, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static void gjson_mutex_init(GJSON_Mutex* mutex)              { pthread_mutex_init(mutex, 0); }
+static void gjson_mutex_lock(GJSON_Mutex* mutex)              { pthread_mutex_lock(mutex); }
+static void gjson_mutex_unlock(GJSON_Mutex* mutex)            { pthread_mutex_unlock(mutex); }
+static void gjson_condition_init(GJSON_Condition* condition)  { pthread_cond_init(condition, 0); }
+static void gjson_condition_wait(GJSON_Condition* condition, GJSON_Mutex* mutex) { pthread_cond_wait(condition, mutex); }
+static void gjson_condition_broadcast(GJSON_Condition* condition) { pthread_cond_broadcast(condition); }
+static void gjson_condition_signal(GJSON_Condition* condition) { pthread_cond_signal(condition); }
+static GJSON_Thread gjson_thread_create(void* (*proc)(void*), void* parameter) { GJSON_Thread thread; pthread_create(&thread, 0, proc, parameter); return thread; }
+static void gjson_thread_join(GJSON_Thread thread) { pthread_join(thread, 0); }
+#endif
+
+#endif
@@ -0,0 +1,605 @@
+#if !defined(JSON_WRITE_H)
+#define JSON_WRITE_H
+
+#include "json.h"
+
+//////////////////////////////////////////////////////////////////////
+// API
+//////////////////////////////////////////////////////////////////////
+
+// NOTE: Called with the bytes written so far whenever the caller
+//       provided buffer is full and on gjson_writer_flush.
+typedef void GJSON_WriterFlush(void* user_data, const char* data, size_t size);
+
+typedef struct GJSON_WriterChunk
+{
+    struct GJSON_WriterChunk* next;
+    size_t size;
+    char*  data;
+} GJSON_WriterChunk;
+
+#define GJSON_WRITER_MAX_DEPTH 64
+typedef struct GJSON_Writer
+{
+    char*  buffer;
+    size_t buffer_size;
+    size_t buffer_used;
+    size_t total_bytes;
+
+    // NOTE: Caller buffer output
+    GJSON_WriterFlush* flush;
+    void*              flush_user_data;
+
+    // NOTE: Arena chunk output
+    MemoryArena*       memory_arena;
+    size_t             chunk_size;
+    GJSON_WriterChunk* first_chunk;
+    GJSON_WriterChunk* last_chunk;
+
+    int  depth;
+    char has_element[GJSON_WRITER_MAX_DEPTH];
+    char after_key;
+} GJSON_Writer;
+
+///////////////////////////////////
+// Methods
+///////////////////////////////////
+static GJSON_Writer gjson_writer_init_buffer(void* buffer, size_t buffer_size, GJSON_WriterFlush* flush, void* flush_user_data);
+static GJSON_Writer gjson_writer_init_arena (MemoryArena* memory_arena, size_t chunk_size);
+// NOTE: Arena output is kept in writer->first_chunk..last_chunk, the last chunk's size is buffer_used
+static void gjson_writer_flush(GJSON_Writer* writer);
+
+static void gjson_write_object_start(GJSON_Writer* writer);
+static void gjson_write_object_end  (GJSON_Writer* writer);
+static void gjson_write_array_start (GJSON_Writer* writer);
+static void gjson_write_array_end   (GJSON_Writer* writer);
+static void gjson_write_key         (GJSON_Writer* writer, const char* key, size_t key_length);
+static void gjson_write_string      (GJSON_Writer* writer, const char* string, size_t string_length);
+static void gjson_write_integer     (GJSON_Writer* writer, s64 value);
+static void gjson_write_double      (GJSON_Writer* writer, f64 value);
+static void gjson_write_bool        (GJSON_Writer* writer, int value);
+static void gjson_write_null        (GJSON_Writer* writer);
+// NOTE: Already encoded JSON value, copied verbatim
+static void gjson_write_raw_value   (GJSON_Writer* writer, const char* data, size_t size);
+
+//////////////////////////////////////////////////////////////////////
+// Output
+//////////////////////////////////////////////////////////////////////
+static void gjson_writer_new_chunk(GJSON_Writer* writer, size_t min_size)
+{
+    gj_Assert(writer->memory_arena);
+    if (writer->last_chunk) writer->last_chunk->size = writer->buffer_used;
+
+    size_t chunk_size = gj_Max(writer->chunk_size, min_size);
+    GJSON_WriterChunk* chunk = PushStruct(writer->memory_arena, GJSON_WriterChunk);
+    chunk->next = NULL;
+    chunk->size = 0;
+    chunk->data = (char*)PushSize(writer->memory_arena, chunk_size);
+
+    if (writer->last_chunk) writer->last_chunk->next = chunk;
+    else                    writer->first_chunk      = chunk;
+    writer->last_chunk  = chunk;
+    writer->buffer      = chunk->data;
+    writer->buffer_size = chunk_size;
+    writer->buffer_used = 0;
+}
+
+static void gjson_writer_flush(GJSON_Writer* writer)
+{
+    if (writer->flush)
+    {
+        if (writer->buffer_used > 0) writer->flush(writer->flush_user_data, writer->buffer, writer->buffer_used);
+        writer->buffer_used = 0;
+    }
+    else if (writer->last_chunk)
+    {
+        writer->last_chunk->size = writer->buffer_used;
+    }
+}
+
+static inline void gjson_writer_reserve(GJSON_Writer* writer, size_t size)
+{
+    if (writer->buffer_used + size <= writer->buffer_size) return;
+
+    if (writer->flush)
+    {
+        gjson_writer_flush(writer);
+    }
+    else
+    {
+        gjson_writer_new_chunk(writer, size);
+    }
+}
+
+static void gjson_writer_put(GJSON_Writer* writer, const char* data, size_t size)
+{
+    writer->total_bytes += size;
+    while (size > 0)
+    {
+        size_t available = writer->buffer_size - writer->buffer_used;
+        if (available == 0)
+        {
+            gjson_writer_reserve(writer, gj_Min(size, writer->chunk_size ? writer->chunk_size : size));
+            available = writer->buffer_size - writer->buffer_used;
+            gj_Assert(available > 0);
+        }
+        size_t copy_size = gj_Min(size, available);
+        memcpy(writer->buffer + writer->buffer_used, data, copy_size);
+        writer->buffer_used += copy_size;
+        data += copy_size;
+        size -= copy_size;
+    }
+}
+
+static inline void gjson_writer_put_char(GJSON_Writer* writer, char c)
+{
+    gjson_writer_reserve(writer, 1);
+    writer->buffer[writer->buffer_used++] = c;
+    writer->total_bytes++;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Structure
+//////////////////////////////////////////////////////////////////////
+static inline void gjson_writer_begin_value(GJSON_Writer* writer)
+{
+    if (writer->after_key)
+    {
+        writer->after_key = gj_False;
+        return;
+    }
+    if (writer->depth > 0)
+    {
+        if (writer->has_element[writer->depth - 1]) gjson_writer_put_char(writer, GJSON_ELEMENT_SEPARATOR);
+        writer->has_element[writer->depth - 1] = gj_True;
+    }
+}
+
+static void gjson_writer_open(GJSON_Writer* writer, char c)
+{
+    gjson_writer_begin_value(writer);
+    gj_Assert(writer->depth < GJSON_WRITER_MAX_DEPTH);
+    writer->has_element[writer->depth++] = gj_False;
+    gjson_writer_put_char(writer, c);
+}
+
+static void gjson_writer_close(GJSON_Writer* writer, char c)
+{
+    gj_Assert(writer->depth > 0 && !writer->after_key);
+    writer->depth--;
+    gjson_writer_put_char(writer, c);
+}
+
+static void gjson_write_object_start(GJSON_Writer* writer) { gjson_writer_open (writer, GJSON_OBJECT_START); }
+static void gjson_write_object_end  (GJSON_Writer* writer) { gjson_writer_close(writer, GJSON_OBJECT_END);   }
+static void gjson_write_array_start (GJSON_Writer* writer) { gjson_writer_open (writer, GJSON_ARRAY_START);  }
+static void gjson_write_array_end   (GJSON_Writer* writer) { gjson_writer_close(writer, GJSON_ARRAY_END);    }
+
+//////////////////////////////////////////////////////////////////////
+// Strings
+//////////////////////////////////////////////////////////////////////
+static const char gjson_hex_digits[] = "0123456789abcdef";
+
+static void gjson_writer_put_escaped(GJSON_Writer* writer, const char* string, size_t string_length)
+{
+    gjson_writer_put_char(writer, GJSON_STRING);
+    while (string_length > 0)
+    {
+        size_t clean = gjson_find_string_special(string, string_length);
+        gjson_writer_put(writer, string, clean);
+        if (clean == string_length) break;
+
+        unsigned char c = (unsigned char)string[clean];
+        char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+        size_t escape_size = 2;
+        switch (c)
+        {
+            case GJSON_STRING: escape[1] = GJSON_STRING; break;
+            case '\\':         escape[1] = '\\'; break;
+            case '\b':         escape[1] = 'b';  break;
+            case '\f':         escape[1] = 'f';  break;
+            case '\n':         escape[1] = 'n';  break;
+            case '\r':         escape[1] = 'r';  break;
+            case '\t':         escape[1] = 't';  break;
+            default:
+            {
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = gjson_hex_digits[c >> 4];
+                escape[5] = gjson_hex_digits[c & 0xF];
+                escape_size = 6;
+            } break;
+        }
+        gjson_writer_put(writer, escape, escape_size);
+
+        string        += clean + 1;
+        string_length -= clean + 1;
+    }
+    gjson_writer_put_char(writer, GJSON_STRING);
+}
+
+static void gjson_write_key(GJSON_Writer* writer, const char* key, size_t key_length)
+{
+    gj_Assert(writer->depth > 0 && !writer->after_key);
+    gjson_writer_begin_value(writer);
+    gjson_writer_put_escaped(writer, key, key_length);
+    gjson_writer_put_char(writer, GJSON_MEMBER_COLON);
+    writer->after_key = gj_True;
+}
+
+static void gjson_write_string(GJSON_Writer* writer, const char* string, size_t string_length)
+{
+    gjson_writer_begin_value(writer);
+    gjson_writer_put_escaped(writer, string, string_length);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Numbers/Literals
+//////////////////////////////////////////////////////////////////////
+static const char gjson_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// NOTE: Writes backwards from end, returns start
+static char* gjson_format_u64(char* end, u64 value)
+{
+    char* cursor = end;
+    while (value >= 100)
+    {
+        u64 pair = (value % 100) * 2;
+        value /= 100;
+        *--cursor = gjson_digit_pairs[pair + 1];
+        *--cursor = gjson_digit_pairs[pair];
+    }
+    if (value >= 10)
+    {
+        *--cursor = gjson_digit_pairs[value * 2 + 1];
+        *--cursor = gjson_digit_pairs[value * 2];
+    }
+    else *--cursor = (char)('0' + value);
+    return cursor;
+}
+
+static void gjson_write_integer(GJSON_Writer* writer, s64 value)
+{
+    gjson_writer_begin_value(writer);
+    char  buffer[24];
+    char* end   = buffer + sizeof(buffer);
+    u64   magnitude = value < 0 ? (u64)0 - (u64)value : (u64)value;
+    char* start = gjson_format_u64(end, magnitude);
+    if (value < 0) *--start = GJSON_SIGN_NEGATIVE;
+    gjson_writer_put(writer, start, end - start);
+}
+
+static void gjson_write_bool(GJSON_Writer* writer, int value)
+{
+    gjson_writer_begin_value(writer);
+    if (value) gjson_writer_put(writer, GJSON_TRUE,  sizeof(GJSON_TRUE)  - 1);
+    else       gjson_writer_put(writer, GJSON_FALSE, sizeof(GJSON_FALSE) - 1);
+}
+
+static void gjson_write_null(GJSON_Writer* writer)
+{
+    gjson_writer_begin_value(writer);
+    gjson_writer_put(writer, GJSON_NULL, sizeof(GJSON_NULL) - 1);
+}
+
+static void gjson_write_raw_value(GJSON_Writer* writer, const char* data, size_t size)
+{
+    gjson_writer_begin_value(writer);
+    gjson_writer_put(writer, data, size);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Doubles
+//////////////////////////////////////////////////////////////////////
+// NOTE: Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and
+//       Accurately with Integers"). Integer arithmetic only, so the output
+//       doesn't depend on the C locale. The digits always parse back to the
+//       same double and are the shortest such digits for nearly all values.
+typedef struct JSONDiyFp
+{
+    u64 f;
+    int e;
+} JSONDiyFp;
+
+#define JSON_DOUBLE_SIGNIFICAND_BITS 52
+#define JSON_DOUBLE_HIDDEN_BIT       ((u64)1 << JSON_DOUBLE_SIGNIFICAND_BITS)
+#define JSON_DOUBLE_EXPONENT_BIAS    (0x3FF + JSON_DOUBLE_SIGNIFICAND_BITS)
+
+// NOTE: Normalized 10^-348, 10^-340, ..., 10^340
+static const u64 gjson_cached_powers_f[] =
+{
+    0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull, 0xcf42894a5dce35eaull,
+    0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull, 0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full,
+    0xbe5691ef416bd60cull, 0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+    0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull, 0xc21094364dfb5637ull,
+    0x9096ea6f3848984full, 0xd77485cb25823ac7ull, 0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull,
+    0xb23867fb2a35b28eull, 0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+    0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull, 0xb5b5ada8aaff80b8ull,
+    0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull, 0x964e858c91ba2655ull, 0xdff9772470297ebdull,
+    0xa6dfbd9fb8e5b88full, 0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+    0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull, 0xaa242499697392d3ull,
+    0xfd87b5f28300ca0eull, 0xbce5086492111aebull, 0x8cbccc096f5088ccull, 0xd1b71758e219652cull,
+    0x9c40000000000000ull, 0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+    0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull, 0x9f4f2726179a2245ull,
+    0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull, 0x83c7088e1aab65dbull, 0xc45d1df942711d9aull,
+    0x924d692ca61be758ull, 0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+    0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull, 0x952ab45cfa97a0b3ull,
+    0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull, 0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull,
+    0x88fcf317f22241e2ull, 0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+    0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull, 0x8bab8eefb6409c1aull,
+    0xd01fef10a657842cull, 0x9b10a4e5e9913129ull, 0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull,
+    0x80444b5e7aa7cf85ull, 0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+    0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+};
+static const int gjson_cached_powers_e[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927, -901, -874, -847, -821,
+    -794, -768, -741, -715, -688, -661, -635, -608, -582, -555, -529, -502, -475, -449, -422, -396,
+    -369, -343, -316, -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+    481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+static const u64 gjson_powers_of_10[] =
+{
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+};
+
+static inline JSONDiyFp gjson_diy_fp(u64 f, int e)
+{
+    JSONDiyFp result;
+    result.f = f;
+    result.e = e;
+    return result;
+}
+
+static inline int gjson_leading_zeros(u64 value)
+{
+    gj_Assert(value);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (int)index;
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+// NOTE: Upper 64 bits of the 128 bit product, rounded
+static JSONDiyFp gjson_diy_fp_multiply(JSONDiyFp a, JSONDiyFp b)
+{
+    u64 a_high = a.f >> 32;
+    u64 a_low  = a.f & 0xFFFFFFFF;
+    u64 b_high = b.f >> 32;
+    u64 b_low  = b.f & 0xFFFFFFFF;
+    u64 high_high = a_high * b_high;
+    u64 high_low  = a_high * b_low;
+    u64 low_high  = a_low  * b_high;
+    u64 low_low   = a_low  * b_low;
+    u64 middle    = (low_low >> 32) + (high_low & 0xFFFFFFFF) + (low_high & 0xFFFFFFFF) + ((u64)1 << 31);
+    return gjson_diy_fp(high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32), a.e + b.e + 64);
+}
+
+// NOTE: Moves the last digit towards w while that stays inside the boundaries
+static void gjson_grisu_round(char* digits, int length, u64 delta, u64 rest, u64 ten_kappa, u64 distance)
+{
+    while (rest < distance && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+// NOTE: Digits of a double > 0, the value is digits * 10^decimal_exponent
+static int gjson_grisu2(f64 value, char* digits, int* decimal_exponent)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    u64 significand = bits & (JSON_DOUBLE_HIDDEN_BIT - 1);
+    int exponent    = (int)((bits >> JSON_DOUBLE_SIGNIFICAND_BITS) & 0x7FF);
+
+    JSONDiyFp v = exponent ? gjson_diy_fp(significand + JSON_DOUBLE_HIDDEN_BIT, exponent - JSON_DOUBLE_EXPONENT_BIAS)
+                           : gjson_diy_fp(significand, 1 - JSON_DOUBLE_EXPONENT_BIAS);
+
+    // NOTE: Halfway to the neighbouring doubles, the lower one is closer
+    //       when v is a power of 2
+    JSONDiyFp plus = gjson_diy_fp((v.f << 1) + 1, v.e - 1);
+    while (!(plus.f & (JSON_DOUBLE_HIDDEN_BIT << 1)))
+    {
+        plus.f <<= 1;
+        plus.e--;
+    }
+    plus.f <<= 64 - JSON_DOUBLE_SIGNIFICAND_BITS - 2;
+    plus.e  -= 64 - JSON_DOUBLE_SIGNIFICAND_BITS - 2;
+    JSONDiyFp minus = v.f == JSON_DOUBLE_HIDDEN_BIT ? gjson_diy_fp((v.f << 2) - 1, v.e - 2)
+                                                    : gjson_diy_fp((v.f << 1) - 1, v.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e   = plus.e;
+
+    int shift = gjson_leading_zeros(v.f);
+    JSONDiyFp w = gjson_diy_fp(v.f << shift, v.e - shift);
+
+    // NOTE: Cached power that brings the products' exponents into [-60, -32]
+    f64 k_estimate = (-61 - plus.e) * 0.30102999566398114 + 347;
+    int k          = (int)k_estimate;
+    if (k_estimate - k > 0.0) k++;
+    int power_index = (k >> 3) + 1;
+    *decimal_exponent = 348 - power_index * 8;
+    JSONDiyFp cached_power = gjson_diy_fp(gjson_cached_powers_f[power_index], gjson_cached_powers_e[power_index]);
+
+    JSONDiyFp scaled       = gjson_diy_fp_multiply(w,     cached_power);
+    JSONDiyFp scaled_plus  = gjson_diy_fp_multiply(plus,  cached_power);
+    JSONDiyFp scaled_minus = gjson_diy_fp_multiply(minus, cached_power);
+    scaled_minus.f++;
+    scaled_plus.f--;
+
+    // NOTE: Generates digits of scaled_plus until they're within delta of it
+    u64 delta    = scaled_plus.f - scaled_minus.f;
+    u64 distance = scaled_plus.f - scaled.f;
+    int one_e    = -scaled_plus.e;
+    u64 one_f    = (u64)1 << one_e;
+    u32 integral = (u32)(scaled_plus.f >> one_e);
+    u64 fraction = scaled_plus.f & (one_f - 1);
+
+    int length = 0;
+    int kappa  = 1;
+    while (kappa < 10 && integral >= gjson_powers_of_10[kappa]) kappa++;
+    while (kappa > 0)
+    {
+        u32 divisor = (u32)gjson_powers_of_10[kappa - 1];
+        u32 digit   = integral / divisor;
+        integral   %= divisor;
+        if (digit || length) digits[length++] = (char)('0' + digit);
+        kappa--;
+
+        u64 rest = ((u64)integral << one_e) + fraction;
+        if (rest <= delta)
+        {
+            *decimal_exponent += kappa;
+            gjson_grisu_round(digits, length, delta, rest, gjson_powers_of_10[kappa] << one_e, distance);
+            return length;
+        }
+    }
+    while (gj_True)
+    {
+        fraction *= 10;
+        delta    *= 10;
+        char digit = (char)(fraction >> one_e);
+        if (digit || length) digits[length++] = (char)('0' + digit);
+        fraction &= one_f - 1;
+        kappa--;
+        if (fraction < delta)
+        {
+            *decimal_exponent += kappa;
+            gjson_grisu_round(digits, length, delta, fraction, one_f, -kappa < 20 ? distance * gjson_powers_of_10[-kappa] : 0);
+            return length;
+        }
+    }
+}
+
+// NOTE: Finite values only, buffer holds at least 32 bytes. Plain decimal
+//       for exponents -6..20 as JavaScript prints them, 1.5e-7 otherwise.
+static int gjson_format_double(char* buffer, f64 value)
+{
+    char* cursor = buffer;
+    if (value < 0.0 || (value == 0.0 && 1.0 / value < 0.0))
+    {
+        *cursor++ = GJSON_SIGN_NEGATIVE;
+        value     = -value;
+    }
+    if (value == 0.0)
+    {
+        *cursor++ = '0';
+        return (int)(cursor - buffer);
+    }
+
+    char digits[20];
+    int  exponent;
+    int  length = gjson_grisu2(value, digits, &exponent);
+    // NOTE: 10^(point - 1) <= value < 10^point
+    int  point  = length + exponent;
+
+    if (exponent >= 0 && point <= 21)
+    {
+        memcpy(cursor, digits, length);
+        memset(cursor + length, '0', exponent);
+        cursor += point;
+    }
+    else if (point > 0 && point <= 21)
+    {
+        memcpy(cursor, digits, point);
+        cursor[point] = GJSON_FRACTION;
+        memcpy(cursor + point + 1, digits + point, length - point);
+        cursor += length + 1;
+    }
+    else if (point > -6 && point <= 0)
+    {
+        *cursor++ = '0';
+        *cursor++ = GJSON_FRACTION;
+        memset(cursor, '0', -point);
+        memcpy(cursor - point, digits, length);
+        cursor += length - point;
+    }
+    else
+    {
+        *cursor++ = digits[0];
+        if (length > 1)
+        {
+            *cursor++ = GJSON_FRACTION;
+            memcpy(cursor, digits + 1, length - 1);
+            cursor += length - 1;
+        }
+        *cursor++ = GJSON_EXPONENT_e;
+        int decimal_exponent = point - 1;
+        if (decimal_exponent < 0)
+        {
+            *cursor++ = GJSON_SIGN_NEGATIVE;
+            decimal_exponent = -decimal_exponent;
+        }
+        char  exponent_digits[4];
+        char* exponent_end   = exponent_digits + sizeof(exponent_digits);
+        char* exponent_start = gjson_format_u64(exponent_end, (u64)decimal_exponent);
+        memcpy(cursor, exponent_start, exponent_end - exponent_start);
+        cursor += exponent_end - exponent_start;
+    }
+    return (int)(cursor - buffer);
+}
+
+static void gjson_write_double(GJSON_Writer* writer, f64 value)
+{
+    // NOTE: JSON has no NaN/Infinity
+    if (value != value || value - value != 0.0)
+    {
+        gjson_write_null(writer);
+        return;
+    }
+
+    if (value >= -9007199254740992.0 && value <= 9007199254740992.0 && value == (f64)(s64)value &&
+        !(value == 0.0 && 1.0 / value < 0.0))
+    {
+        gjson_write_integer(writer, (s64)value);
+        return;
+    }
+
+    gjson_writer_begin_value(writer);
+    char buffer[32];
+    int  length = gjson_format_double(buffer, value);
+    gjson_writer_put(writer, buffer, length);
+}
+
+//////////////////////////////////////////////////////////////////////
+// API Implementation
+//////////////////////////////////////////////////////////////////////
+static GJSON_Writer gjson_writer_init_buffer(void* buffer, size_t buffer_size, GJSON_WriterFlush* flush, void* flush_user_data)
+{
+    gj_Assert(buffer && buffer_size > 0 && flush);
+    GJSON_Writer result;
+    gj_ZeroMemory(&result);
+    result.buffer          = (char*)buffer;
+    result.buffer_size     = buffer_size;
+    result.flush           = flush;
+    result.flush_user_data = flush_user_data;
+    return result;
+}
+
+static GJSON_Writer gjson_writer_init_arena(MemoryArena* memory_arena, size_t chunk_size)
+{
+    gj_Assert(chunk_size > 0);
+    GJSON_Writer result;
+    gj_ZeroMemory(&result);
+    result.memory_arena = memory_arena;
+    result.chunk_size   = chunk_size;
+    gjson_writer_new_chunk(&result, chunk_size);
+    return result;
+}
+
+#endif
@@ -0,0 +1,683 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gj/gj_base.h>
+
+#include "json.h"
+#include "json_query.h"
+#include "json_write.h"
+
+// NOTE: Define GJSON_BENCH_YYJSON to 1 and compile yyjson/src/yyjson.c
+//       (build.sh does when the yyjson sources are checked out) to run yyjson
+//       on the same corpus as a reference parser
+#if !defined(GJSON_BENCH_YYJSON)
+#define GJSON_BENCH_YYJSON 0
+#endif
+#if GJSON_BENCH_YYJSON
+#include <yyjson.h>
+#endif
+
+#define BENCH_MAX_RESULTS 16
+
+typedef struct BenchCorpus
+{
+    const char* name;
+    // NOTE: Followed by GJSON_PADDING zero bytes for gjson_search_small
+    char*       data;
+    size_t      size;
+    // NOTE: Documents are one per line, enables the per-document benchmarks
+    int         newline_delimited;
+
+    GJSON_Query query;
+    char        needle[GJSON_NEEDLE_SIZE];
+    size_t      needle_length;
+    GJSON_State gjson;
+} BenchCorpus;
+
+typedef struct BenchResult
+{
+    const char* name;
+    u64    hits;
+    f64    mb_per_s;
+    // NOTE: Per iteration, or per document for per-document benchmarks
+    f64    p50_us;
+    f64    p99_us;
+    // NOTE: Peak of the child process the benchmark ran in, above that of an
+    //       idle child (corpus, timings and harness)
+    long   peak_rss_kb;
+} BenchResult;
+
+#define BENCH_METRIC_COUNT 4
+
+typedef struct BenchMetric
+{
+    const char* key;
+    // NOTE: Throughput regresses when it drops, latency and RSS when they grow
+    int         higher_is_better;
+    // NOTE: Absolute allowance on top of the relative threshold
+    f64         slack;
+} BenchMetric;
+
+// NOTE: RSS moves by pages and allocator chunks even without code changes
+static const BenchMetric bench_metrics[BENCH_METRIC_COUNT] =
+{
+    { "mb_per_s",    gj_True,  0.0   },
+    { "p50_us",      gj_False, 0.0   },
+    { "p99_us",      gj_False, 0.0   },
+    { "peak_rss_kb", gj_False, 512.0 },
+};
+
+typedef u64 BenchFunction(BenchCorpus* corpus);
+
+static f64 bench_metric_value(BenchResult* result, int metric)
+{
+    switch (metric)
+    {
+        case 0: return result->mb_per_s;
+        case 1: return result->p50_us;
+        case 2: return result->p99_us;
+        case 3: return (f64)result->peak_rss_kb;
+        InvalidDefaultCase;
+    }
+    return 0.0;
+}
+
+static u64 bench_time_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000000000ull + (u64)now.tv_nsec;
+}
+
+static void bench_sift_down(u64* values, size_t root, size_t count)
+{
+    while (2 * root + 1 < count)
+    {
+        size_t child = 2 * root + 1;
+        if (child + 1 < count && values[child + 1] > values[child]) child++;
+        if (values[root] >= values[child]) return;
+        u64 value     = values[root];
+        values[root]  = values[child];
+        values[child] = value;
+        root = child;
+    }
+}
+
+// NOTE: In-place heapsort, qsort allocates scratch that would show up in peak RSS
+static void bench_sort_u64(u64* values, size_t count)
+{
+    for (size_t i = count / 2; i > 0; i--) bench_sift_down(values, i - 1, count);
+    for (size_t end = count; end > 1; end--)
+    {
+        u64 value       = values[0];
+        values[0]       = values[end - 1];
+        values[end - 1] = value;
+        bench_sift_down(values, 0, end - 1);
+    }
+}
+
+// NOTE: timings must be sorted
+static f64 bench_percentile_us(u64* timings, size_t count, f64 percentile)
+{
+    if (count == 0) return 0.0;
+    return (f64)timings[(size_t)(percentile * (f64)(count - 1))] / 1000.0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Benchmarks
+//////////////////////////////////////////////////////////////////////
+// NOTE: Same 64 KB buffering as a file driver would use
+#define BENCH_BUFFER_SIZE Kilobytes(64)
+
+static u64 bench_search(BenchCorpus* corpus)
+{
+    u64    hits   = 0;
+    size_t offset = 0;
+    gjson_reset(&corpus->gjson);
+    while (offset < corpus->size)
+    {
+        size_t buffer_end = gj_Min(corpus->size, (offset / BENCH_BUFFER_SIZE + 1) * BENCH_BUFFER_SIZE);
+        corpus->gjson.data = corpus->data + offset;
+        corpus->gjson.size = buffer_end - offset;
+        GJSON_QueryResult result = gjson_search(&corpus->gjson, corpus->query);
+        offset += result.read_bytes;
+        if (result.type == GJSON_QueryResultType_Hit) hits++;
+        if (result.type == GJSON_QueryResultType_Error) break;
+    }
+    return hits;
+}
+
+static u64 bench_search_raw_key(BenchCorpus* corpus)
+{
+    u64    hits   = 0;
+    size_t offset = 0;
+    while (offset < corpus->size)
+    {
+        corpus->gjson.data = corpus->data + offset;
+        corpus->gjson.size = corpus->size - offset;
+        GJSON_QueryResult result = gjson_search_raw_key(&corpus->gjson, corpus->query);
+        offset += result.read_bytes;
+        if (result.type != GJSON_QueryResultType_Hit) break;
+        hits++;
+    }
+    return hits;
+}
+
+static u64 bench_aggregate_count(BenchCorpus* corpus)
+{
+    GJSON_Aggregate aggregate;
+    gj_ZeroMemory(&aggregate);
+    aggregate.type  = GJSON_AggregateType_Count;
+    aggregate.query = corpus->query;
+
+    gjson_reset(&corpus->gjson);
+    corpus->gjson.data = corpus->data;
+    corpus->gjson.size = corpus->size;
+    gjson_aggregate(&corpus->gjson, &aggregate);
+    return aggregate.count;
+}
+
+// NOTE: Raw scan for the quoted key, the ceiling for any key search
+static u64 bench_memmem(BenchCorpus* corpus)
+{
+    u64    hits   = 0;
+    size_t offset = 0;
+    while (offset < corpus->size)
+    {
+        offset += gjson_memmem(corpus->data + offset, corpus->size - offset, corpus->needle, corpus->needle_length);
+        if (offset == corpus->size) break;
+        offset += corpus->needle_length;
+        hits++;
+    }
+    return hits;
+}
+
+// NOTE: No parser work, its peak RSS is what the other benchmarks are measured above
+static u64 bench_idle(BenchCorpus* corpus)
+{
+    return 0;
+}
+
+#if GJSON_BENCH_YYJSON
+static u64 bench_yyjson_count(BenchCorpus* corpus, yyjson_val* value)
+{
+    u64    result = 0;
+    size_t index;
+    size_t max;
+    if (yyjson_is_obj(value))
+    {
+        yyjson_val* key;
+        yyjson_val* member;
+        yyjson_obj_foreach(value, index, max, key, member)
+        {
+            if (yyjson_get_len(key) == (size_t)corpus->query.string_length &&
+                memcmp(yyjson_get_str(key), corpus->query.string, yyjson_get_len(key)) == 0)
+            {
+                result++;
+            }
+            result += bench_yyjson_count(corpus, member);
+        }
+    }
+    else if (yyjson_is_arr(value))
+    {
+        yyjson_val* element;
+        yyjson_arr_foreach(value, index, max, element)
+        {
+            result += bench_yyjson_count(corpus, element);
+        }
+    }
+    return result;
+}
+
+// NOTE: Full DOM parse of every top-level value, then a walk for the key
+static u64 bench_yyjson(BenchCorpus* corpus)
+{
+    u64    hits   = 0;
+    size_t cursor = 0;
+    while (gj_True)
+    {
+        while (cursor < corpus->size && gj_IsWhitespace(corpus->data[cursor])) cursor++;
+        if (cursor == corpus->size) break;
+
+        yyjson_read_err error;
+        yyjson_doc* document = yyjson_read_opts(corpus->data + cursor, corpus->size - cursor,
+                                                YYJSON_READ_STOP_WHEN_DONE, NULL, &error);
+        if (!document) break;
+        hits   += bench_yyjson_count(corpus, yyjson_doc_get_root(document));
+        cursor += yyjson_doc_get_read_size(document);
+        yyjson_doc_free(document);
+    }
+    return hits;
+}
+#endif
+
+static BenchResult bench_run(const char* name, BenchFunction* function, BenchCorpus* corpus, int iterations, u64* timings)
+{
+    BenchResult result;
+    gj_ZeroMemory(&result);
+    result.name = name;
+
+    for (int i = 0; i < iterations; i++)
+    {
+        u64 start   = bench_time_ns();
+        result.hits = function(corpus);
+        timings[i]  = bench_time_ns() - start;
+    }
+
+    bench_sort_u64(timings, (size_t)iterations);
+    result.p50_us      = bench_percentile_us(timings, iterations, 0.50);
+    result.p99_us      = bench_percentile_us(timings, iterations, 0.99);
+    result.mb_per_s    = result.p50_us > 0.0 ? ((f64)corpus->size / (1024.0 * 1024.0)) / (result.p50_us / 1000000.0) : 0.0;
+    return result;
+}
+
+// NOTE: Latency is per document (line), the request path case
+static BenchResult bench_run_small(BenchCorpus* corpus, int iterations, u64* timings, size_t timing_count)
+{
+    BenchResult result;
+    gj_ZeroMemory(&result);
+    result.name = "search_small";
+
+    GJSON_QueryResult hits[64];
+    u64    total_ns       = 0;
+    size_t document_count = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        result.hits    = 0;
+        document_count = 0;
+        size_t start   = 0;
+        while (start < corpus->size)
+        {
+            char*  end  = (char*)memchr(corpus->data + start, '\n', corpus->size - start);
+            size_t size = (end ? (size_t)(end - corpus->data) : corpus->size) - start;
+
+            u64 document_start = bench_time_ns();
+            int hit_count      = gjson_search_small(corpus->data + start, size, corpus->query, hits, (int)(sizeof(hits) / sizeof(hits[0])));
+            u64 document_ns    = bench_time_ns() - document_start;
+            total_ns += document_ns;
+            if (hit_count > 0) result.hits += hit_count;
+            if (document_count < timing_count) timings[document_count] = document_ns;
+            document_count++;
+
+            start += size + 1;
+        }
+    }
+
+    size_t count = gj_Min(document_count, timing_count);
+    bench_sort_u64(timings, count);
+    result.p50_us      = bench_percentile_us(timings, count, 0.50);
+    result.p99_us      = bench_percentile_us(timings, count, 0.99);
+    result.mb_per_s    = total_ns ? ((f64)corpus->size * iterations / (1024.0 * 1024.0)) / ((f64)total_ns / 1000000000.0) : 0.0;
+    return result;
+}
+
+// NOTE: Runs bench_run (bench_run_small if function is NULL) in a forked
+//       child so peak RSS is what that benchmark touched, not the high water
+//       mark of every benchmark before it. Every child touches all of
+//       timings up front so the harness costs the same in each.
+static BenchResult bench_run_isolated(const char* name, BenchFunction* function, BenchCorpus* corpus,
+                                      int iterations, u64* timings, size_t timing_count)
+{
+    BenchResult result;
+    gj_ZeroMemory(&result);
+    result.name = name;
+
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0)
+    {
+        printf("Benchmark [%s] failed to run\n", name);
+        return result;
+    }
+
+    fflush(stdout);
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(pipe_fds[0]);
+        memset(timings, 0, timing_count * sizeof(u64));
+        BenchResult child_result = function ? bench_run(name, function, corpus, iterations, timings)
+                                            : bench_run_small(corpus, iterations, timings, timing_count);
+        ssize_t written = write(pipe_fds[1], &child_result, sizeof(child_result));
+        _exit(written == (ssize_t)sizeof(child_result) ? 0 : 1);
+    }
+    close(pipe_fds[1]);
+
+    BenchResult   child_result;
+    struct rusage usage;
+    int           status;
+    ssize_t read_bytes = child > 0 ? read(pipe_fds[0], &child_result, sizeof(child_result)) : 0;
+    close(pipe_fds[0]);
+    if (child > 0 && wait4(child, &status, 0, &usage) == child &&
+        WIFEXITED(status) && WEXITSTATUS(status) == 0 && read_bytes == (ssize_t)sizeof(child_result))
+    {
+        result             = child_result;
+        result.peak_rss_kb = usage.ru_maxrss;
+    }
+    else printf("Benchmark [%s] failed to run\n", name);
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Output/Baseline
+//////////////////////////////////////////////////////////////////////
+static void bench_flush_file(void* user_data, const char* data, size_t size)
+{
+    fwrite(data, 1, size, (FILE*)user_data);
+}
+
+static void bench_write_key(GJSON_Writer* writer, const char* key)
+{
+    gjson_write_key(writer, key, strlen(key));
+}
+
+static int bench_write_results(const char* path, BenchCorpus* corpus, int iterations, BenchResult* results, int result_count)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file) return gj_False;
+
+    char buffer[4096];
+    GJSON_Writer writer = gjson_writer_init_buffer(buffer, sizeof(buffer), bench_flush_file, file);
+    gjson_write_object_start(&writer);
+    bench_write_key(&writer, "corpus");     gjson_write_string(&writer, corpus->name, strlen(corpus->name));
+    bench_write_key(&writer, "size");       gjson_write_integer(&writer, (s64)corpus->size);
+    bench_write_key(&writer, "iterations"); gjson_write_integer(&writer, iterations);
+    bench_write_key(&writer, "results");
+    gjson_write_array_start(&writer);
+    for (int i = 0; i < result_count; i++)
+    {
+        BenchResult* result = &results[i];
+        gjson_write_object_start(&writer);
+        bench_write_key(&writer, "name");        gjson_write_string(&writer, result->name, strlen(result->name));
+        bench_write_key(&writer, "mb_per_s");    gjson_write_double(&writer, result->mb_per_s);
+        bench_write_key(&writer, "p50_us");      gjson_write_double(&writer, result->p50_us);
+        bench_write_key(&writer, "p99_us");      gjson_write_double(&writer, result->p99_us);
+        bench_write_key(&writer, "hits");        gjson_write_integer(&writer, (s64)result->hits);
+        bench_write_key(&writer, "peak_rss_kb"); gjson_write_integer(&writer, result->peak_rss_kb);
+        gjson_write_object_end(&writer);
+    }
+    gjson_write_array_end(&writer);
+    gjson_write_object_end(&writer);
+    gjson_writer_put_char(&writer, '\n');
+    gjson_writer_flush(&writer);
+
+    fclose(file);
+    return gj_True;
+}
+
+static char* bench_read_file(const char* path, size_t* size)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* result = (char*)calloc(*size + GJSON_PADDING, 1);
+    if (result && fread(result, 1, *size, file) != *size)
+    {
+        free(result);
+        result = NULL;
+    }
+    fclose(file);
+    return result;
+}
+
+// NOTE: Compares every metric of the results named name against one
+//       baseline entry, a metric the baseline lacks or has as a non-number
+//       fails. Returns the number of failed metrics.
+static int bench_check_entry(const char* name, size_t name_length, f64* baseline, int* baseline_found,
+                             f64* thresholds, BenchResult* results, int result_count)
+{
+    int regressions = 0;
+    for (int i = 0; i < result_count; i++)
+    {
+        if (strlen(results[i].name) != name_length || memcmp(results[i].name, name, name_length) != 0) continue;
+
+        for (int metric = 0; metric < BENCH_METRIC_COUNT; metric++)
+        {
+            const BenchMetric* info  = &bench_metrics[metric];
+            f64                value = bench_metric_value(&results[i], metric);
+            if (!baseline_found[metric])
+            {
+                printf("%-20s %-12s %12.3f baseline missing or not a number REGRESSION\n", results[i].name, info->key, value);
+                regressions++;
+                continue;
+            }
+
+            f64 limit     = info->higher_is_better ? baseline[metric] * (1.0 - thresholds[metric]) - info->slack
+                                                   : baseline[metric] * (1.0 + thresholds[metric]) + info->slack;
+            int regressed = info->higher_is_better ? value < limit : value > limit;
+            printf("%-20s %-12s %12.3f baseline %12.3f limit %12.3f%s\n", results[i].name, info->key,
+                   value, baseline[metric], limit, regressed ? " REGRESSION" : "");
+            if (regressed) regressions++;
+        }
+    }
+    return regressions;
+}
+
+// NOTE: Baseline is an earlier results file, read with our own query API.
+//       Returns the number of metrics worse than baseline by more than their
+//       threshold, or -1 if the baseline can't be read.
+static int bench_check_baseline(const char* path, f64* thresholds, BenchResult* results, int result_count)
+{
+    size_t size;
+    char*  data = bench_read_file(path, &size);
+    if (!data) return -1;
+
+    // NOTE: name, then the metrics in bench_metrics order
+    GJSON_QueryKey keys[1 + BENCH_METRIC_COUNT];
+    keys[0].string        = (char*)"name";
+    keys[0].string_length = 4;
+    for (int metric = 0; metric < BENCH_METRIC_COUNT; metric++)
+    {
+        keys[1 + metric].string        = (char*)bench_metrics[metric].key;
+        keys[1 + metric].string_length = (int)strlen(bench_metrics[metric].key);
+    }
+    GJSON_Query query;
+    query.type      = GJSON_QueryType_ObjectKeys;
+    query.key_count = (int)(sizeof(keys) / sizeof(keys[0]));
+    query.keys      = keys;
+
+    char        memory[1024];
+    GJSON_State gjson = gjson_init(memory, sizeof(memory));
+
+    int         regressions = 0;
+    const char* name        = NULL;
+    size_t      name_length = 0;
+    f64         baseline[BENCH_METRIC_COUNT];
+    int         baseline_found[BENCH_METRIC_COUNT];
+    size_t      offset      = 0;
+    while (offset < size)
+    {
+        gjson.data = data + offset;
+        gjson.size = size - offset;
+        GJSON_QueryResult result = gjson_search(&gjson, query);
+        offset += result.read_bytes;
+        if (result.type != GJSON_QueryResultType_Hit) break;
+
+        gjson.data = data + offset;
+        gjson.size = size - offset;
+        GJSON_Span value;
+        if (gjson_skip_member_value(&gjson, &value) != GJSON_QueryResultType_Hit) break;
+        const char* value_data = data + offset + value.start;
+        size_t      value_size = value.end - value.start;
+        offset += value.end;
+
+        if (result.key_index == 0)
+        {
+            if (name) regressions += bench_check_entry(name, name_length, baseline, baseline_found, thresholds, results, result_count);
+            // NOTE: Names are plain identifiers, no unescaping needed
+            name        = value_data + 1;
+            name_length = value_size >= 2 ? value_size - 2 : 0;
+            memset(baseline_found, 0, sizeof(baseline_found));
+            continue;
+        }
+
+        int metric = result.key_index - 1;
+        baseline_found[metric] = gjson_value_number(value_data, value_size, &baseline[metric]);
+    }
+    if (name) regressions += bench_check_entry(name, name_length, baseline, baseline_found, thresholds, results, result_count);
+
+    free(data);
+    // NOTE: Malformed or cut off baseline
+    if (!gjson_parse_queue_complete(gjson.parse_queue)) return -1;
+    return regressions;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Main
+//////////////////////////////////////////////////////////////////////
+static void bench_usage()
+{
+    printf("usage: linux_bench <corpus.json> <key> [--ndjson] [--iterations N]\n"
+           "                   [--output results.json] [--baseline results.json] [--threshold 0.10]\n"
+           "                   [--p50-threshold 0.10] [--p99-threshold 0.25] [--rss-threshold 0.10]\n");
+}
+
+int main(int argc, char** args)
+{
+    if (argc < 3)
+    {
+        bench_usage();
+        return 2;
+    }
+
+    BenchCorpus corpus;
+    gj_ZeroMemory(&corpus);
+    corpus.name = args[1];
+
+    int         iterations    = 10;
+    const char* output_path   = NULL;
+    const char* baseline_path = NULL;
+    // NOTE: Relative allowance per metric in bench_metrics order, p99 is the noisiest
+    f64         thresholds[BENCH_METRIC_COUNT] = { 0.10, 0.10, 0.25, 0.10 };
+    for (int i = 3; i < argc; i++)
+    {
+        if      (strcmp(args[i], "--ndjson") == 0)                    corpus.newline_delimited = gj_True;
+        else if (strcmp(args[i], "--iterations") == 0 && i + 1 < argc) iterations    = atoi(args[++i]);
+        else if (strcmp(args[i], "--output")     == 0 && i + 1 < argc) output_path   = args[++i];
+        else if (strcmp(args[i], "--baseline")   == 0 && i + 1 < argc) baseline_path = args[++i];
+        else if (strcmp(args[i], "--threshold")     == 0 && i + 1 < argc) thresholds[0] = atof(args[++i]);
+        else if (strcmp(args[i], "--p50-threshold") == 0 && i + 1 < argc) thresholds[1] = atof(args[++i]);
+        else if (strcmp(args[i], "--p99-threshold") == 0 && i + 1 < argc) thresholds[2] = atof(args[++i]);
+        else if (strcmp(args[i], "--rss-threshold") == 0 && i + 1 < argc) thresholds[3] = atof(args[++i]);
+        else
+        {
+            bench_usage();
+            return 2;
+        }
+    }
+    if (iterations < 1) iterations = 1;
+
+    corpus.data = bench_read_file(corpus.name, &corpus.size);
+    if (!corpus.data)
+    {
+        printf("Can't read [%s]\n", corpus.name);
+        return 2;
+    }
+
+    size_t key_length = strlen(args[2]);
+    if (key_length + 2 > GJSON_NEEDLE_SIZE)
+    {
+        printf("Key too long\n");
+        return 2;
+    }
+    corpus.query.type          = GJSON_QueryType_ObjectKey;
+    corpus.query.string        = args[2];
+    corpus.query.string_length = (int)key_length;
+    corpus.needle[corpus.needle_length++] = GJSON_STRING;
+    memcpy(corpus.needle + corpus.needle_length, args[2], key_length);
+    corpus.needle_length += key_length;
+    corpus.needle[corpus.needle_length++] = GJSON_STRING;
+
+    // NOTE: Aggregates/raw key only need the parse stack
+    size_t working_memory_size = Kilobytes(64);
+    void*  working_memory      = malloc(working_memory_size);
+    corpus.gjson = gjson_init(working_memory, working_memory_size);
+
+    printf("Benchmarking [%s] (%.1f MB) for key [%s], %d iterations\n",
+           corpus.name, (f64)corpus.size / (1024.0 * 1024.0), args[2], iterations);
+
+    // NOTE: One timing per iteration, or per document for search_small
+    size_t timing_count = (size_t)iterations;
+    if (corpus.newline_delimited)
+    {
+        size_t document_count = 1;
+        for (char* line_end = corpus.data; (line_end = (char*)memchr(line_end, '\n', corpus.size - (size_t)(line_end - corpus.data))); line_end++)
+        {
+            document_count++;
+        }
+        timing_count = gj_Max(timing_count, document_count);
+    }
+    u64* timings = (u64*)malloc(timing_count * sizeof(u64));
+
+    BenchResult idle = bench_run_isolated("idle", bench_idle, &corpus, 1, timings, timing_count);
+
+    BenchResult results[BENCH_MAX_RESULTS];
+    int         result_count = 0;
+    results[result_count++] = bench_run_isolated("search",          bench_search,          &corpus, iterations, timings, timing_count);
+    results[result_count++] = bench_run_isolated("search_raw_key",  bench_search_raw_key,  &corpus, iterations, timings, timing_count);
+    results[result_count++] = bench_run_isolated("aggregate_count", bench_aggregate_count, &corpus, iterations, timings, timing_count);
+    if (corpus.newline_delimited)
+    {
+        results[result_count++] = bench_run_isolated("search_small",    NULL,                  &corpus, iterations, timings, timing_count);
+    }
+    results[result_count++] = bench_run_isolated("memmem",          bench_memmem,          &corpus, iterations, timings, timing_count);
+#if GJSON_BENCH_YYJSON
+    results[result_count++] = bench_run_isolated("yyjson",          bench_yyjson,          &corpus, iterations, timings, timing_count);
+#endif
+
+    for (int i = 0; i < result_count; i++)
+    {
+        results[i].peak_rss_kb = gj_Max(results[i].peak_rss_kb - idle.peak_rss_kb, 0L);
+    }
+    printf("Peak RSS is above an idle child's %ld KB\n", idle.peak_rss_kb);
+
+    int result = 0;
+    printf("%-20s %10s %12s %12s %12s %12s\n", "name", "MB/s", "p50 us", "p99 us", "hits", "peak RSS KB");
+    for (int i = 0; i < result_count; i++)
+    {
+        BenchResult* bench_result = &results[i];
+        printf("%-20s %10.1f %12.3f %12.3f %12llu %12ld\n", bench_result->name, bench_result->mb_per_s,
+               bench_result->p50_us, bench_result->p99_us, (unsigned long long)bench_result->hits, bench_result->peak_rss_kb);
+
+        // NOTE: memmem also counts the key inside strings, it's only a speed reference
+        if (strcmp(bench_result->name, "memmem") != 0 && bench_result->hits != results[0].hits)
+        {
+            printf("%s found %llu hits, search found %llu\n", bench_result->name,
+                   (unsigned long long)bench_result->hits, (unsigned long long)results[0].hits);
+            result = 1;
+        }
+    }
+
+    if (output_path && !bench_write_results(output_path, &corpus, iterations, results, result_count))
+    {
+        printf("Can't write [%s]\n", output_path);
+        result = 2;
+    }
+
+    if (baseline_path)
+    {
+        int regressions = bench_check_baseline(baseline_path, thresholds, results, result_count);
+        if (regressions < 0)
+        {
+            printf("Can't read baseline [%s]\n", baseline_path);
+            result = 2;
+        }
+        else if (regressions > 0)
+        {
+            printf("%d benchmark metric(s) regressed past their threshold\n", regressions);
+            result = 1;
+        }
+    }
+
+    free(timings);
+    free(working_memory);
+    free(corpus.data);
+    return result;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gj/gj_base.h>
+
+#include "json.h"
+#include "json_query.h"
+
+// NOTE: [{"pad":"xxx...xxx"},{"login":1}] as valid JSON past 4 GB without
+//       writing 4 GB: the file holds a head page, one pad block of 'x' and a
+//       tail page, and the pad block is mapped LARGE_PAD_COUNT times in a row
+#define LARGE_HEAD         "[{\"pad\":\""
+#define LARGE_TAIL         "\"},{\"login\":1}]"
+#define LARGE_PAGE_SIZE    Kilobytes(4)
+#define LARGE_PAD_SIZE     Megabytes(1)
+#define LARGE_PAD_COUNT    4097
+// NOTE: Opening quote of "login" within LARGE_TAIL
+#define LARGE_KEY_OFFSET   4
+
+static int large_failures;
+
+static void large_check(int condition, const char* what, u64 value, u64 expected)
+{
+    printf("%-28s %12llu %s\n", what, (unsigned long long)value, condition ? "ok" : "FAILED");
+    if (!condition)
+    {
+        printf("%-28s %12llu\n", "  expected", (unsigned long long)expected);
+        large_failures++;
+    }
+}
+
+static int large_create_file(const char* path)
+{
+    int file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) return gj_False;
+
+    char* block = (char*)malloc(LARGE_PAD_SIZE);
+    memset(block, 'x', LARGE_PAD_SIZE);
+    int result = pwrite(file, block, LARGE_PAD_SIZE, LARGE_PAGE_SIZE) == (ssize_t)LARGE_PAD_SIZE;
+
+    memcpy(block, LARGE_HEAD, sizeof(LARGE_HEAD) - 1);
+    result = result && pwrite(file, block, LARGE_PAGE_SIZE, 0) == (ssize_t)LARGE_PAGE_SIZE;
+
+    memset(block, 'x', LARGE_PAGE_SIZE);
+    memcpy(block + LARGE_PAGE_SIZE - (sizeof(LARGE_TAIL) - 1), LARGE_TAIL, sizeof(LARGE_TAIL) - 1);
+    result = result && pwrite(file, block, LARGE_PAGE_SIZE, LARGE_PAGE_SIZE + LARGE_PAD_SIZE) == (ssize_t)LARGE_PAGE_SIZE;
+
+    free(block);
+    close(file);
+    return result;
+}
+
+// NOTE: Reserves the whole range first so the MAP_FIXED pieces can't land on anything else
+static char* large_map_file(int file, u64 size)
+{
+    char* data = (char*)mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) return 0;
+
+    int result = mmap(data, LARGE_PAGE_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED, file, 0) != MAP_FAILED;
+    u64 offset = LARGE_PAGE_SIZE;
+    for (int i = 0; result && i < LARGE_PAD_COUNT; i++, offset += LARGE_PAD_SIZE)
+    {
+        result = mmap(data + offset, LARGE_PAD_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED, file, LARGE_PAGE_SIZE) != MAP_FAILED;
+    }
+    result = result && mmap(data + offset, LARGE_PAGE_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED, file, LARGE_PAGE_SIZE + LARGE_PAD_SIZE) != MAP_FAILED;
+    if (!result)
+    {
+        munmap(data, size);
+        return 0;
+    }
+    return data;
+}
+
+int main(int argc, char** args)
+{
+    const char* path = argc > 1 ? args[1] : "large_test.json";
+    u64 size = LARGE_PAGE_SIZE + LARGE_PAD_SIZE * LARGE_PAD_COUNT + LARGE_PAGE_SIZE;
+    if (!large_create_file(path))
+    {
+        printf("Can't create file [%s]\n", path);
+        unlink(path);
+        return 2;
+    }
+
+    int   file = open(path, O_RDONLY);
+    char* data = file >= 0 ? large_map_file(file, size) : 0;
+    if (!data)
+    {
+        printf("Can't map [%s]\n", path);
+        if (file >= 0) close(file);
+        unlink(path);
+        return 2;
+    }
+    printf("Searching [%s] (%llu bytes)\n", path, (unsigned long long)size);
+
+    size_t working_memory_size = Kilobytes(64);
+    void*  working_memory      = malloc(working_memory_size);
+    GJSON_State gjson = gjson_init(working_memory, working_memory_size);
+
+    GJSON_Query query;
+    gj_ZeroMemory(&query);
+    query.type          = GJSON_QueryType_ObjectKey;
+    query.string        = (char*)"login";
+    query.string_length = 5;
+
+    u64 key_start = size - (sizeof(LARGE_TAIL) - 1) + LARGE_KEY_OFFSET;
+    u64 key_end   = key_start + sizeof("\"login\"") - 1;
+
+    gjson.data = data;
+    gjson.size = size;
+    GJSON_QueryResult result = gjson_search(&gjson, query);
+    large_check(result.type == GJSON_QueryResultType_Hit, "search result type", result.type, GJSON_QueryResultType_Hit);
+    large_check(result.match_start == key_start,          "search match_start", result.match_start, key_start);
+    large_check(result.read_bytes  == key_end,            "search read_bytes",  result.read_bytes,  key_end);
+
+    GJSON_Span value;
+    gjson.data = data + result.read_bytes;
+    gjson.size = size - result.read_bytes;
+    GJSON_QueryResultType skip = gjson_skip_member_value(&gjson, &value);
+    large_check(skip == GJSON_QueryResultType_Hit, "skip value type", skip, GJSON_QueryResultType_Hit);
+    large_check(result.read_bytes + value.start == key_end + 1 && data[result.read_bytes + value.start] == '1',
+                "skip value offset", result.read_bytes + value.start, key_end + 1);
+
+    gjson_reset(&gjson);
+    gjson.data = data;
+    gjson.size = size;
+    result = gjson_search_raw_key(&gjson, query);
+    large_check(result.type == GJSON_QueryResultType_Hit, "raw key result type", result.type, GJSON_QueryResultType_Hit);
+    large_check(result.match_start == key_start,          "raw key match_start", result.match_start, key_start);
+
+    GJSON_Aggregate aggregate;
+    gj_ZeroMemory(&aggregate);
+    aggregate.type  = GJSON_AggregateType_Sum;
+    aggregate.query = query;
+    gjson_reset(&gjson);
+    gjson.data = data;
+    gjson.size = size;
+    GJSON_QueryResultType aggregate_result = gjson_aggregate(&gjson, &aggregate);
+    large_check(aggregate_result != GJSON_QueryResultType_Error && aggregate.count == 1 && aggregate.value == 1.0,
+                "aggregate sum count", aggregate.count, 1);
+    large_check(aggregate.read_bytes == size, "aggregate read_bytes", aggregate.read_bytes, size);
+
+    munmap(data, size);
+    close(file);
+    unlink(path);
+
+    printf("%s\n", large_failures ? "FAILED" : "All checks passed");
+    return large_failures ? 1 : 0;
+}
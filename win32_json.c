@@ -38,11 +38,13 @@ int main(int argc, char** args)
     LARGE_INTEGER start;
     QueryPerformanceCounter(&start);
 
-    size_t working_memory_size = Gigabytes(1);
+    // NOTE: gjson_search only needs its parse stack, report the high water mark
+    //       below to size this for other query types
+    size_t working_memory_size = gjson_minimum_memory_size();
     void*  working_memory      = g_platform_api.allocate_memory(working_memory_size);
     GJSON_State json = gjson_init(working_memory, working_memory_size);
     GJSON_Query query_object_key;
-    query_object.type = GJSON_QueryType_ObjectKey;
+    query_object_key.type = GJSON_QueryType_ObjectKey;
     char query_key_string[] = "login";
     {
         query_object_key.string_length = 5;
@@ -60,21 +62,27 @@ int main(int argc, char** args)
         json.data = json_data;
         json.size = json_data_buffer_size;
             
-        GJSON_QueryResult result = gjson_search(&json, query_object);
-        gj_Assert(result.read_bytes != 0);
+        GJSON_QueryResult result = gjson_search(&json, query_object_key);
         switch (result.type)
         {
             case GJSON_QueryResultType_Hit:
                 hits++;
             case GJSON_QueryResultType_NeedMoreBytes:
+                // NOTE: Errors can stop at byte 0, anything else makes progress
+                gj_Assert(result.read_bytes != 0);
                 json_data_read_bytes += result.read_bytes;
                 break;
+            case GJSON_QueryResultType_Error:
+                printf("Malformed JSON at byte %zu\n", json_data_read_bytes + result.read_bytes);
+                json_data_read_bytes = json_file_handle.file_size;
+                break;
 
             InvalidDefaultCase;
         }
     }
     gj_Assert(json_data_read_bytes == json_file_handle.file_size);
     printf("Hits: %d\n", hits);
+    printf("Working memory high water mark: %zu bytes\n", gjson_memory_high_water_mark(&json));
     
     {
         LARGE_INTEGER end;